@@ -112,6 +112,7 @@ FORWARD_TO_SIMULATION_API(requestSpeedChange);
 FORWARD_TO_SIMULATION_API(setEntityStatus);
 FORWARD_TO_SIMULATION_API(setVelocityLimit);
 FORWARD_TO_SIMULATION_API(updateFrame);
+FORWARD_TO_SIMULATION_API(writeUpdateCostLog);
 
 #undef FORWARD_TO_SIMULATION_API
 
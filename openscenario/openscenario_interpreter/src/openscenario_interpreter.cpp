@@ -74,8 +74,25 @@ auto Interpreter::makeCurrentConfiguration() const -> traffic_simulator::Configu
     configuration.initialize_duration =
       ObjectController::ego_count > 0 ? getParameter<int>("initialize_duration") : 0;
 
+    configuration.entity_status_publish_rate = getParameter<double>("entity_status_publish_rate");
+
+    configuration.compact_entity_status = getParameter<bool>("compact_entity_status");
+
+    configuration.lod_full_radius = getParameter<double>("lod_full_radius");
+
+    configuration.lod_reduced_radius = getParameter<double>("lod_reduced_radius");
+
+    configuration.lod_reduced_interval =
+      static_cast<std::size_t>(std::max(getParameter<int>("lod_reduced_interval", 4), 1));
+
+    configuration.profile_behavior_trees = getParameter<bool>("profile_behavior_trees");
+
+    configuration.lidar_map_geometry = getParameter<bool>("lidar_map_geometry");
+
     configuration.scenario_path = osc_path;
 
+    configuration.update_cost_log_path = getParameter<std::string>("update_cost_log_path");
+
     // XXX DIRTY HACK!!!
     if (not logic_file.isDirectory() and logic_file.filepath.extension() == ".osm") {
       configuration.lanelet2_map_file = logic_file.filepath.filename().string();
@@ -199,6 +216,8 @@ auto Interpreter::on_deactivate(const rclcpp_lifecycle::State &) -> Result
 
   publisher_of_context->on_deactivate();
 
+  writeUpdateCostLog();
+
   disconnect();  // Deactivate traffic_simulator
 
   scenarios.pop_front();
@@ -127,6 +127,11 @@ private:
    * @brief buffers for generated markers.
    */
   std::unordered_map<std::string, visualization_msgs::msg::MarkerArray> markers_;
+  /**
+   * @brief buffers for the latest trajectories, which are omitted from the message while unchanged.
+   */
+  std::unordered_map<std::string, traffic_simulator_msgs::msg::EntityStatusWithTrajectory>
+    trajectories_;
 };
 }  // namespace openscenario_visualization
 
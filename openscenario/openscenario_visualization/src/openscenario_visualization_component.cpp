@@ -87,10 +87,16 @@ void OpenscenarioVisualizationComponent::entityStatusCallback(
   }
   for (const auto & name : erase_names) {
     markers_.erase(markers_.find(name));
+    trajectories_.erase(name);
   }
   for (const auto & data : msg->data) {
-    auto marker_array =
-      generateMarker(data.status, data.goal_pose, data.waypoint, data.obstacle, data.obstacle_find);
+    if (data.trajectory_updated) {
+      trajectories_[data.name] = data;
+    }
+    const auto & trajectory = trajectories_.count(data.name) ? trajectories_[data.name] : data;
+    auto marker_array = generateMarker(
+      data.status, trajectory.goal_pose, trajectory.waypoint, trajectory.obstacle,
+      trajectory.obstacle_find);
     std::copy(
       marker_array.markers.begin(), marker_array.markers.end(),
       std::back_inserter(current_marker.markers));
@@ -20,6 +20,7 @@
 #include <boost/algorithm/clamp.hpp>
 #include <memory>
 #include <string>
+#include <traffic_simulator/behavior/lanelet_entity_index.hpp>
 #include <traffic_simulator/entity/entity_base.hpp>
 #include <traffic_simulator/hdmap_utils/hdmap_utils.hpp>
 #include <traffic_simulator/helper/stop_watch.hpp>
@@ -35,6 +36,10 @@ namespace entity_behavior
 class ActionNode : public BT::ActionNodeBase
 {
 public:
+  typedef std::unordered_map<std::string, traffic_simulator_msgs::msg::EntityType> EntityTypeDict;
+  typedef std::unordered_map<std::string, traffic_simulator_msgs::msg::EntityStatus>
+    EntityStatusDict;
+
   ActionNode(const std::string & name, const BT::NodeConfiguration & config);
   ~ActionNode() override = default;
   bool foundConflictingEntity(const std::vector<std::int64_t> & following_lanelets) const;
@@ -42,10 +47,10 @@ public:
     const std::vector<std::int64_t> & route_lanelets,
     const traffic_simulator::math::CatmullRomSpline & spline);
   boost::optional<std::string> getFrontEntityName(
-    const traffic_simulator::math::CatmullRomSpline & spline);
+    const traffic_simulator::math::CatmullRomSpline & spline, double look_ahead_distance);
   double calculateStopDistance() const;
   boost::optional<double> getDistanceToFrontEntity(
-    const traffic_simulator::math::CatmullRomSpline & spline);
+    const traffic_simulator::math::CatmullRomSpline & spline, double look_ahead_distance);
   boost::optional<double> getDistanceToStopLine(
     const std::vector<std::int64_t> & route_lanelets,
     const std::vector<geometry_msgs::msg::Point> & waypoints);
@@ -65,6 +70,11 @@ public:
   /// throws if the derived class return RUNNING.
   BT::NodeStatus executeTick() override;
 
+  /**
+   * @brief Name of the behavior under which the tick time of this node is profiled.
+   */
+  void setBehaviorName(const std::string & behavior_name) { behavior_name_ = behavior_name; }
+
   void halt() override final { setStatus(BT::NodeStatus::IDLE); }
 
   static BT::PortsList providedPorts()
@@ -78,11 +88,10 @@ public:
       BT::InputPort<boost::optional<double>>("target_speed"),
       BT::OutputPort<traffic_simulator_msgs::msg::EntityStatus>("updated_status"),
       BT::OutputPort<std::string>("request"),
-      BT::InputPort<std::unordered_map<std::string, traffic_simulator_msgs::msg::EntityStatus>>(
-        "other_entity_status"),
-      BT::InputPort<std::unordered_map<std::string, traffic_simulator_msgs::msg::EntityType>>(
-        "entity_type_list"),
-      BT::InputPort<std::vector<std::int64_t>>("route_lanelets"),
+      BT::InputPort<std::shared_ptr<const EntityStatusDict>>("other_entity_status"),
+      BT::InputPort<std::shared_ptr<const LaneletEntityIndex>>("lanelet_entity_index"),
+      BT::InputPort<std::shared_ptr<const EntityTypeDict>>("entity_type_list"),
+      BT::InputPort<std::shared_ptr<const std::vector<std::int64_t>>>("route_lanelets"),
       BT::InputPort<std::shared_ptr<traffic_simulator::TrafficLightManagerBase>>(
         "traffic_light_manager"),
       BT::OutputPort<boost::optional<traffic_simulator_msgs::msg::Obstacle>>("obstacle"),
@@ -97,16 +106,30 @@ public:
   double step_time;
   boost::optional<double> target_speed;
   traffic_simulator_msgs::msg::EntityStatus updated_status;
-  std::unordered_map<std::string, traffic_simulator_msgs::msg::EntityStatus> other_entity_status;
-  std::unordered_map<std::string, traffic_simulator_msgs::msg::EntityType> entity_type_list;
-  std::vector<std::int64_t> route_lanelets;
+  /**
+   * @note Inputs whose size grows with the number of entities are shared with the behavior plugin
+   * and the other nodes of the tree instead of being copied on every tick. They are immutable and
+   * replaced by the plugin every frame. other_entity_status holds the statuses of all entities,
+   * including this one, and is shared by all entities.
+   */
+  std::shared_ptr<const EntityStatusDict> other_entity_status;
+  std::shared_ptr<const LaneletEntityIndex> lanelet_entity_index;
+  std::shared_ptr<const EntityTypeDict> entity_type_list;
+  std::shared_ptr<const std::vector<std::int64_t>> route_lanelets;
   traffic_simulator_msgs::msg::EntityStatus getEntityStatus(const std::string target_name) const;
+  /**
+   * @note Only the other entities closer than other_entity_range are taken into account, as
+   * lanelet_entity_index and other_entity_status hold every entity.
+   */
+  bool isOtherEntity(const traffic_simulator_msgs::msg::EntityStatus & status) const;
+  bool hasOtherEntityOnLanelet(std::int64_t lanelet_id) const;
   boost::optional<double> getDistanceToTargetEntityPolygon(
     const traffic_simulator::math::CatmullRomSpline & spline, const std::string target_name,
     double width_extension_right = 0.0, double width_extension_left = 0.0,
     double length_extension_front = 0.0, double length_extension_rear = 0.0);
 
 private:
+  std::string behavior_name_;
   boost::optional<double> getDistanceToTargetEntityOnCrosswalk(
     const traffic_simulator::math::CatmullRomSpline & spline,
     const traffic_simulator_msgs::msg::EntityStatus & status);
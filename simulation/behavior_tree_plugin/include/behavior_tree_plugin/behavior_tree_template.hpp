@@ -0,0 +1,60 @@
+// Copyright 2015-2020 Tier IV, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef BEHAVIOR_TREE_PLUGIN__BEHAVIOR_TREE_TEMPLATE_HPP_
+#define BEHAVIOR_TREE_PLUGIN__BEHAVIOR_TREE_TEMPLATE_HPP_
+
+#include <behaviortree_cpp_v3/bt_factory.h>
+#include <behaviortree_cpp_v3/xml_parsing.h>
+
+#include <functional>
+#include <mutex>
+#include <string>
+
+namespace entity_behavior
+{
+/**
+ * @brief Behavior tree XML that is parsed and validated once, and instantiated for each entity.
+ */
+class BehaviorTreeTemplate
+{
+public:
+  using NodeRegistration = std::function<void(BT::BehaviorTreeFactory &)>;
+
+  BehaviorTreeTemplate(const std::string & path, const NodeRegistration & register_nodes);
+
+  BehaviorTreeTemplate(const BehaviorTreeTemplate &) = delete;
+
+  auto operator=(const BehaviorTreeTemplate &) -> BehaviorTreeTemplate & = delete;
+
+  auto instantiate() -> BT::Tree;
+
+private:
+  BT::BehaviorTreeFactory factory_;
+
+  BT::XMLParser parser_;
+
+  std::mutex mutex_;
+};
+
+/**
+ * @brief Returns the process-wide template of the behavior tree file.
+ * @note register_nodes is only called the first time a template is requested for the path.
+ */
+auto getBehaviorTreeTemplate(
+  const std::string & path, const BehaviorTreeTemplate::NodeRegistration & register_nodes)
+  -> BehaviorTreeTemplate &;
+}  // namespace entity_behavior
+
+#endif  // BEHAVIOR_TREE_PLUGIN__BEHAVIOR_TREE_TEMPLATE_HPP_
@@ -25,6 +25,7 @@
 #include <geometry_msgs/msg/point.hpp>
 #include <map>
 #include <memory>
+#include <scenario_simulator_exception/exception.hpp>
 #include <string>
 #include <traffic_simulator/behavior/behavior_plugin_base.hpp>
 #include <traffic_simulator/hdmap_utils/hdmap_utils.hpp>
@@ -47,20 +48,39 @@ public:
     tree_.rootBlackboard()->set<TYPE>(get##NAME##Key(), value);                             \
   }
 
+  // Stored as an immutable shared handle, so that action nodes read it without copying it on
+  // every tick.
+#define DEFINE_SHARED_GETTER_SETTER(NAME, TYPE)                                             \
+  TYPE get##NAME() override                                                                 \
+  {                                                                                         \
+    const auto value =                                                                      \
+      tree_.rootBlackboard()->get<std::shared_ptr<const TYPE>>(get##NAME##Key());           \
+    if (!value) {                                                                           \
+      THROW_SIMULATION_ERROR(get##NAME##Key(), " is not set");                              \
+    }                                                                                       \
+    return *value;                                                                          \
+  }                                                                                         \
+  void set##NAME(const TYPE & value) override                                               \
+  {                                                                                         \
+    tree_.rootBlackboard()->set<std::shared_ptr<const TYPE>>(                               \
+      get##NAME##Key(), std::make_shared<const TYPE>(value));                               \
+  }
+
   // clang-format off
   DEFINE_GETTER_SETTER(CurrentTime, double)
   DEFINE_GETTER_SETTER(DebugMarker, std::vector<visualization_msgs::msg::Marker>)
   DEFINE_GETTER_SETTER(DriverModel, traffic_simulator_msgs::msg::DriverModel)
   DEFINE_GETTER_SETTER(EntityStatus, traffic_simulator_msgs::msg::EntityStatus)
-  DEFINE_GETTER_SETTER(EntityTypeList, EntityTypeDict)
+  DEFINE_GETTER_SETTER(EntityTypeList, std::shared_ptr<const EntityTypeDict>)
   DEFINE_GETTER_SETTER(GoalPoses, std::vector<geometry_msgs::msg::Pose>)
   DEFINE_GETTER_SETTER(HdMapUtils, std::shared_ptr<hdmap_utils::HdMapUtils>)
   DEFINE_GETTER_SETTER(LaneChangeParameters, traffic_simulator::lane_change::Parameter)
+  DEFINE_GETTER_SETTER(LaneletEntityIndex, std::shared_ptr<const LaneletEntityIndex>)
   DEFINE_GETTER_SETTER(Obstacle, boost::optional<traffic_simulator_msgs::msg::Obstacle>)
-  DEFINE_GETTER_SETTER(OtherEntityStatus, EntityStatusDict)
+  DEFINE_GETTER_SETTER(OtherEntityStatus, std::shared_ptr<const EntityStatusDict>)
   DEFINE_GETTER_SETTER(PedestrianParameters, traffic_simulator_msgs::msg::PedestrianParameters)
   DEFINE_GETTER_SETTER(Request, std::string)
-  DEFINE_GETTER_SETTER(RouteLanelets, std::vector<std::int64_t>)
+  DEFINE_SHARED_GETTER_SETTER(RouteLanelets, std::vector<std::int64_t>)
   DEFINE_GETTER_SETTER(StepTime, double)
   DEFINE_GETTER_SETTER(TargetSpeed, boost::optional<double>)
   DEFINE_GETTER_SETTER(TrafficLightManager, std::shared_ptr<traffic_simulator::TrafficLightManagerBase>)
@@ -70,10 +90,11 @@ public:
   // clang-format on
 
 #undef DEFINE_GETTER_SETTER
+#undef DEFINE_SHARED_GETTER_SETTER
 
 private:
+  static void registerNodes(BT::BehaviorTreeFactory & factory);
   BT::NodeStatus tickOnce(double current_time, double step_time);
-  BT::BehaviorTreeFactory factory_;
   BT::Tree tree_;
   std::unique_ptr<behavior_tree_plugin::LoggingEvent> logging_event_ptr_;
   std::unique_ptr<behavior_tree_plugin::ResetRequestEvent> reset_request_event_ptr_;
@@ -0,0 +1,120 @@
+// Copyright 2015-2020 Tier IV, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef BEHAVIOR_TREE_PLUGIN__PEDESTRIAN__CROWD_HPP_
+#define BEHAVIOR_TREE_PLUGIN__PEDESTRIAN__CROWD_HPP_
+
+#include <behavior_tree_plugin/pedestrian/crowd_geometry.hpp>
+#include <boost/optional.hpp>
+#include <memory>
+#include <string>
+#include <traffic_simulator/behavior/behavior_plugin_base.hpp>
+#include <traffic_simulator/hdmap_utils/hdmap_utils.hpp>
+#include <traffic_simulator_msgs/msg/entity_status.hpp>
+#include <vector>
+#include <visualization_msgs/msg/marker_array.hpp>
+
+namespace entity_behavior
+{
+/**
+ * @brief Lightweight pedestrian behavior for crowds.
+ * @note Accepts the same requests as PedestrianBehaviorTree ("none", "follow_lane" and
+ * "walk_straight") without ticking a behavior tree, and updates all the crowd pedestrians of a
+ * frame in one batch. Crowd pedestrians do not react to other entities, so the status and types
+ * of the other entities are not kept.
+ * @note Only the behavior update is batched. The entity side still runs per pedestrian every
+ * frame: EntityBase::setOtherStatus and the route planning of PedestrianEntity are not skipped
+ * for crowd members.
+ */
+class PedestrianCrowd : public BehaviorPluginBase
+{
+public:
+  void configure(const rclcpp::Logger & logger) override;
+  void update(double current_time, double step_time) override;
+  const std::string & getCurrentAction() const override { return current_action_; }
+  bool supportsBatchUpdate() const override { return true; }
+  void updateBatch(
+    const std::vector<BehaviorPluginBase *> & plugins, const WorldSnapshot & world) override;
+
+#define DEFINE_GETTER_SETTER(NAME, TYPE, MEMBER) \
+  TYPE get##NAME() override { return MEMBER; }   \
+  void set##NAME(const TYPE & value) override { MEMBER = value; }
+
+  // clang-format off
+  DEFINE_GETTER_SETTER(CurrentTime, double, current_time_)
+  DEFINE_GETTER_SETTER(DebugMarker, std::vector<visualization_msgs::msg::Marker>, debug_marker_)
+  DEFINE_GETTER_SETTER(DriverModel, traffic_simulator_msgs::msg::DriverModel, driver_model_)
+  DEFINE_GETTER_SETTER(EntityStatus, traffic_simulator_msgs::msg::EntityStatus, entity_status_)
+  DEFINE_GETTER_SETTER(GoalPoses, std::vector<geometry_msgs::msg::Pose>, goal_poses_)
+  DEFINE_GETTER_SETTER(HdMapUtils, std::shared_ptr<hdmap_utils::HdMapUtils>, hdmap_utils_)
+  DEFINE_GETTER_SETTER(LaneChangeParameters, traffic_simulator::lane_change::Parameter, lane_change_parameters_)
+  DEFINE_GETTER_SETTER(Obstacle, boost::optional<traffic_simulator_msgs::msg::Obstacle>, obstacle_)
+  DEFINE_GETTER_SETTER(PedestrianParameters, traffic_simulator_msgs::msg::PedestrianParameters, pedestrian_parameters_)
+  DEFINE_GETTER_SETTER(Request, std::string, request_)
+  DEFINE_GETTER_SETTER(RouteLanelets, std::vector<std::int64_t>, route_lanelets_)
+  DEFINE_GETTER_SETTER(StepTime, double, step_time_)
+  DEFINE_GETTER_SETTER(TargetSpeed, boost::optional<double>, target_speed_)
+  DEFINE_GETTER_SETTER(TrafficLightManager, std::shared_ptr<traffic_simulator::TrafficLightManagerBase>, traffic_light_manager_)
+  DEFINE_GETTER_SETTER(UpdatedStatus, traffic_simulator_msgs::msg::EntityStatus, updated_status_)
+  DEFINE_GETTER_SETTER(VehicleParameters, traffic_simulator_msgs::msg::VehicleParameters, vehicle_parameters_)
+  DEFINE_GETTER_SETTER(Waypoints, traffic_simulator_msgs::msg::WaypointsArray, waypoints_)
+  // clang-format on
+
+#undef DEFINE_GETTER_SETTER
+
+  std::shared_ptr<const EntityTypeDict> getEntityTypeList() override { return nullptr; }
+  void setEntityTypeList(const std::shared_ptr<const EntityTypeDict> &) override {}
+  std::shared_ptr<const EntityStatusDict> getOtherEntityStatus() override { return nullptr; }
+  void setOtherEntityStatus(const std::shared_ptr<const EntityStatusDict> &) override {}
+  std::shared_ptr<const LaneletEntityIndex> getLaneletEntityIndex() override { return nullptr; }
+  void setLaneletEntityIndex(const std::shared_ptr<const LaneletEntityIndex> &) override {}
+
+private:
+  /**
+   * @brief The crowd geometry of the current map, created on first use.
+   */
+  auto getGeometry() -> const std::shared_ptr<pedestrian::CrowdGeometry> &;
+  void step(pedestrian::CrowdGeometry & geometry);
+  auto calculateAccel(double target_speed) const -> double;
+  auto followLane(pedestrian::CrowdGeometry & geometry) const
+    -> traffic_simulator_msgs::msg::EntityStatus;
+  auto walkStraight(pedestrian::CrowdGeometry & geometry) const
+    -> traffic_simulator_msgs::msg::EntityStatus;
+  auto matchToLanelet(pedestrian::CrowdGeometry & geometry, const geometry_msgs::msg::Pose & pose)
+    const -> boost::optional<traffic_simulator_msgs::msg::LaneletPose>;
+  auto stopAtEndOfRoad() const -> traffic_simulator_msgs::msg::EntityStatus;
+
+  std::string current_action_ = "root";
+  std::shared_ptr<pedestrian::CrowdGeometry> geometry_;
+  double current_time_ = 0;
+  double step_time_ = 0;
+  std::vector<visualization_msgs::msg::Marker> debug_marker_;
+  traffic_simulator_msgs::msg::DriverModel driver_model_;
+  traffic_simulator_msgs::msg::EntityStatus entity_status_;
+  std::vector<geometry_msgs::msg::Pose> goal_poses_;
+  std::shared_ptr<hdmap_utils::HdMapUtils> hdmap_utils_;
+  traffic_simulator::lane_change::Parameter lane_change_parameters_;
+  boost::optional<traffic_simulator_msgs::msg::Obstacle> obstacle_;
+  traffic_simulator_msgs::msg::PedestrianParameters pedestrian_parameters_;
+  std::string request_ = "none";
+  std::vector<std::int64_t> route_lanelets_;
+  boost::optional<double> target_speed_;
+  std::shared_ptr<traffic_simulator::TrafficLightManagerBase> traffic_light_manager_;
+  traffic_simulator_msgs::msg::EntityStatus updated_status_;
+  traffic_simulator_msgs::msg::VehicleParameters vehicle_parameters_;
+  traffic_simulator_msgs::msg::WaypointsArray waypoints_;
+};
+}  // namespace entity_behavior
+
+#endif  // BEHAVIOR_TREE_PLUGIN__PEDESTRIAN__CROWD_HPP_
@@ -0,0 +1,69 @@
+// Copyright 2015-2020 Tier IV, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef BEHAVIOR_TREE_PLUGIN__PEDESTRIAN__CROWD_GEOMETRY_HPP_
+#define BEHAVIOR_TREE_PLUGIN__PEDESTRIAN__CROWD_GEOMETRY_HPP_
+
+#include <cstdint>
+#include <memory>
+#include <traffic_simulator/hdmap_utils/hdmap_utils.hpp>
+#include <unordered_map>
+#include <vector>
+
+namespace entity_behavior
+{
+namespace pedestrian
+{
+/**
+ * @brief Length, speed limit and previous and next lanelets of the lanelets crowd pedestrians walk
+ * on, looked up in the map once per lanelet.
+ * @note Shared by the crowd pedestrians of a batch and released with the last of them. Not
+ * thread safe, like the behavior plugins that own it.
+ */
+class CrowdGeometry
+{
+public:
+  struct Lanelet
+  {
+    double length;
+
+    double speed_limit;
+
+    std::vector<std::int64_t> previous;
+
+    std::vector<std::int64_t> next;
+  };
+
+  explicit CrowdGeometry(const std::shared_ptr<hdmap_utils::HdMapUtils> & hdmap_utils);
+
+  CrowdGeometry(const CrowdGeometry &) = delete;
+
+  auto operator=(const CrowdGeometry &) -> CrowdGeometry & = delete;
+
+  auto getHdMapUtils() const -> const std::shared_ptr<hdmap_utils::HdMapUtils> &
+  {
+    return hdmap_utils_;
+  }
+
+  auto getLanelet(std::int64_t lanelet_id) -> const Lanelet &;
+
+private:
+  const std::shared_ptr<hdmap_utils::HdMapUtils> hdmap_utils_;
+
+  std::unordered_map<std::int64_t, Lanelet> lanelets_;
+};
+}  // namespace pedestrian
+}  // namespace entity_behavior
+
+#endif  // BEHAVIOR_TREE_PLUGIN__PEDESTRIAN__CROWD_GEOMETRY_HPP_
@@ -0,0 +1,103 @@
+// Copyright 2015-2020 Tier IV, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef BEHAVIOR_TREE_PLUGIN__VEHICLE__ROUTE_CONTEXT_HPP_
+#define BEHAVIOR_TREE_PLUGIN__VEHICLE__ROUTE_CONTEXT_HPP_
+
+#include <boost/optional.hpp>
+#include <cstdint>
+#include <geometry_msgs/msg/point.hpp>
+#include <memory>
+#include <traffic_simulator/hdmap_utils/hdmap_utils.hpp>
+#include <traffic_simulator/traffic_lights/traffic_light_manager.hpp>
+#include <traffic_simulator_msgs/msg/lanelet_pose.hpp>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace entity_behavior
+{
+/**
+ * @brief Features along route_lanelets that do not change while the route stays the same.
+ * @note Built once when route_lanelets changes. Positions are in lanelet coordinates, i.e. the
+ * sum of the lengths of the preceding route lanelets plus the s of the lanelet pose, the same
+ * scale entities move along, so each query only looks up the current position and the next
+ * feature ahead of it.
+ * When the entity is not on a route lanelet, e.g. while it changes lanes, the distance queries
+ * fall back to the collision of the features with its waypoints.
+ */
+class RouteContext
+{
+public:
+  RouteContext(
+    const std::shared_ptr<hdmap_utils::HdMapUtils> & hdmap_utils,
+    const std::vector<std::int64_t> & route_lanelets);
+
+  auto getRouteLanelets() const -> const std::vector<std::int64_t> & { return route_lanelets_; }
+
+  auto getSpeedLimit() const -> double { return speed_limit_; }
+
+  auto getRightOfWayLaneletIds(std::int64_t lanelet_id) const -> const std::vector<std::int64_t> &;
+
+  /**
+   * @brief Distance along the route from the pose to the beginning of the lanelet, or none if
+   * the lanelet is behind the pose or not on the route.
+   */
+  auto getLongitudinalDistance(
+    const traffic_simulator_msgs::msg::LaneletPose & from, std::int64_t to_lanelet_id) const
+    -> boost::optional<double>;
+
+  auto getDistanceToStopLine(
+    const traffic_simulator_msgs::msg::LaneletPose & from, double horizon,
+    const std::vector<geometry_msgs::msg::Point> & waypoints) const -> boost::optional<double>;
+
+  auto getDistanceToTrafficLightStopLine(
+    const traffic_simulator_msgs::msg::LaneletPose & from, double horizon,
+    const std::vector<geometry_msgs::msg::Point> & waypoints) const -> boost::optional<double>;
+
+  /**
+   * @brief Same as above, but only the stop lines of red or yellow traffic lights count.
+   */
+  auto getDistanceToTrafficLightStopLine(
+    const traffic_simulator_msgs::msg::LaneletPose & from, double horizon,
+    const std::vector<geometry_msgs::msg::Point> & waypoints,
+    traffic_simulator::TrafficLightManagerBase & traffic_light_manager) const
+    -> boost::optional<double>;
+
+private:
+  auto getS(const traffic_simulator_msgs::msg::LaneletPose & pose) const -> boost::optional<double>;
+
+  /**
+   * @brief Position of the first crossing of the line with the center line of a route lanelet.
+   */
+  auto getCollisionPoint(const std::vector<geometry_msgs::msg::Point> & line) const
+    -> boost::optional<double>;
+
+  const std::shared_ptr<hdmap_utils::HdMapUtils> hdmap_utils_;
+
+  const std::vector<std::int64_t> route_lanelets_;
+
+  const double speed_limit_;
+
+  std::unordered_map<std::int64_t, double> lanelet_start_s_;
+
+  std::unordered_map<std::int64_t, std::vector<std::int64_t>> right_of_way_lanelet_ids_;
+
+  std::vector<double> stop_line_s_;
+
+  std::vector<std::pair<double, std::int64_t>> traffic_light_stop_line_s_;
+};
+}  // namespace entity_behavior
+
+#endif  // BEHAVIOR_TREE_PLUGIN__VEHICLE__ROUTE_CONTEXT_HPP_
@@ -18,6 +18,7 @@
 #include <behaviortree_cpp_v3/action_node.h>
 
 #include <behavior_tree_plugin/action_node.hpp>
+#include <behavior_tree_plugin/vehicle/route_context.hpp>
 #include <memory>
 #include <string>
 #include <traffic_simulator/helper/stop_watch.hpp>
@@ -40,7 +41,10 @@ public:
   {
     BT::PortsList ports = {
       BT::InputPort<traffic_simulator_msgs::msg::DriverModel>("driver_model"),
-      BT::InputPort<traffic_simulator_msgs::msg::VehicleParameters>("vehicle_parameters")};
+      BT::InputPort<traffic_simulator_msgs::msg::VehicleParameters>("vehicle_parameters"),
+      BT::InputPort<std::shared_ptr<const traffic_simulator::math::CatmullRomSpline>>(
+        "route_spline"),
+      BT::InputPort<std::shared_ptr<const RouteContext>>("route_context")};
     BT::PortsList parent_ports = entity_behavior::ActionNode::providedPorts();
     for (const auto & parent_port : parent_ports) {
       ports.emplace(parent_port.first, parent_port.second);
@@ -52,6 +56,24 @@ public:
     double target_speed, const std::vector<std::int64_t> & following_lanelets);
   traffic_simulator_msgs::msg::EntityStatus calculateEntityStatusUpdatedInWorldFrame(
     double target_speed);
+  /**
+   * @brief Spline along the center line of route_lanelets, shared by all nodes of the tree.
+   */
+  auto getRouteSpline() const -> const traffic_simulator::math::CatmullRomSpline &;
+  /**
+   * @brief Speed limit, stop lines and right of way along route_lanelets, shared by all nodes of
+   * the tree.
+   */
+  auto getRouteContext() const -> const RouteContext &;
+  /**
+   * @brief Same as getRightOfWayEntities(*route_lanelets).empty() == false, without querying the
+   * map.
+   */
+  auto hasRightOfWayEntitiesOnRoute() const -> bool;
+  /**
+   * @brief Same as getYieldStopDistance(*route_lanelets), without querying the map.
+   */
+  auto getYieldStopDistanceOnRoute() const -> boost::optional<double>;
   virtual const traffic_simulator_msgs::msg::WaypointsArray calculateWaypoints() = 0;
   virtual const boost::optional<traffic_simulator_msgs::msg::Obstacle> calculateObstacle(
     const traffic_simulator_msgs::msg::WaypointsArray & waypoints) = 0;
@@ -59,6 +81,8 @@ public:
 protected:
   traffic_simulator_msgs::msg::DriverModel driver_model;
   traffic_simulator_msgs::msg::VehicleParameters vehicle_parameters;
+  std::shared_ptr<const traffic_simulator::math::CatmullRomSpline> route_spline;
+  std::shared_ptr<const RouteContext> route_context;
 };
 }  // namespace entity_behavior
 
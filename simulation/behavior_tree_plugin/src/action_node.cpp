@@ -16,11 +16,14 @@
 
 #include <algorithm>
 #include <behavior_tree_plugin/action_node.hpp>
+#include <chrono>
+#include <cmath>
 #include <memory>
 #include <rclcpp/rclcpp.hpp>
 #include <scenario_simulator_exception/exception.hpp>
 #include <set>
 #include <string>
+#include <traffic_simulator/behavior/behavior_tree_profiler.hpp>
 #include <traffic_simulator/math/bounding_box.hpp>
 #include <unordered_map>
 #include <utility>
@@ -33,7 +36,17 @@ ActionNode::ActionNode(const std::string & name, const BT::NodeConfiguration & c
 {
 }
 
-BT::NodeStatus ActionNode::executeTick() { return BT::ActionNodeBase::executeTick(); }
+BT::NodeStatus ActionNode::executeTick()
+{
+  auto & profiler = entity_behavior::BehaviorTreeProfiler::get();
+  if (!profiler.enabled()) {
+    return BT::ActionNodeBase::executeTick();
+  }
+  const auto start = std::chrono::steady_clock::now();
+  const auto status = BT::ActionNodeBase::executeTick();
+  profiler.addTick(behavior_name_, registrationName(), std::chrono::steady_clock::now() - start);
+  return status;
+}
 
 void ActionNode::getBlackBoardValues()
 {
@@ -61,15 +74,27 @@ void ActionNode::getBlackBoardValues()
     target_speed = boost::none;
   }
 
-  if (!getInput<std::unordered_map<std::string, traffic_simulator_msgs::msg::EntityStatus>>(
-        "other_entity_status", other_entity_status)) {
+  if (
+    !getInput<std::shared_ptr<const EntityStatusDict>>(
+      "other_entity_status", other_entity_status) ||
+    !other_entity_status) {
     THROW_SIMULATION_ERROR("failed to get input other_entity_status in ActionNode");
   }
-  if (!getInput<std::unordered_map<std::string, traffic_simulator_msgs::msg::EntityType>>(
-        "entity_type_list", entity_type_list)) {
+  if (
+    !getInput<std::shared_ptr<const LaneletEntityIndex>>(
+      "lanelet_entity_index", lanelet_entity_index) ||
+    !lanelet_entity_index) {
+    THROW_SIMULATION_ERROR("failed to get input lanelet_entity_index in ActionNode");
+  }
+  if (
+    !getInput<std::shared_ptr<const EntityTypeDict>>("entity_type_list", entity_type_list) ||
+    !entity_type_list) {
     THROW_SIMULATION_ERROR("failed to get input entity_type_list in ActionNode");
   }
-  if (!getInput<std::vector<std::int64_t>>("route_lanelets", route_lanelets)) {
+  if (
+    !getInput<std::shared_ptr<const std::vector<std::int64_t>>>(
+      "route_lanelets", route_lanelets) ||
+    !route_lanelets) {
     THROW_SIMULATION_ERROR("failed to get input route_lanelets in ActionNode");
   }
 }
@@ -92,11 +117,9 @@ std::vector<traffic_simulator_msgs::msg::EntityStatus> ActionNode::getOtherEntit
   std::int64_t lanelet_id)
 {
   std::vector<traffic_simulator_msgs::msg::EntityStatus> ret;
-  for (const auto & status : other_entity_status) {
-    if (status.second.lanelet_pose_valid) {
-      if (status.second.lanelet_pose.lanelet_id == lanelet_id) {
-        ret.emplace_back(status.second);
-      }
+  for (const auto status : lanelet_entity_index->getEntityStatus(lanelet_id)) {
+    if (isOtherEntity(*status)) {
+      ret.emplace_back(*status);
     }
   }
   return ret;
@@ -130,11 +153,11 @@ std::vector<traffic_simulator_msgs::msg::EntityStatus> ActionNode::getRightOfWay
 {
   std::vector<traffic_simulator_msgs::msg::EntityStatus> ret;
   const auto lanelet_ids_list = hdmap_utils->getRightOfWayLaneletIds(following_lanelets);
-  for (const auto & status : other_entity_status) {
-    for (const auto & following_lanelet : following_lanelets) {
-      for (const std::int64_t & lanelet_id : lanelet_ids_list.at(following_lanelet)) {
-        if (lanelet_id == status.second.lanelet_pose.lanelet_id) {
-          ret.emplace_back(status.second);
+  for (const auto & following_lanelet : following_lanelets) {
+    for (const std::int64_t & lanelet_id : lanelet_ids_list.at(following_lanelet)) {
+      for (const auto status : lanelet_entity_index->getEntityStatus(lanelet_id)) {
+        if (isOtherEntity(*status)) {
+          ret.emplace_back(*status);
         }
       }
     }
@@ -150,10 +173,10 @@ std::vector<traffic_simulator_msgs::msg::EntityStatus> ActionNode::getRightOfWay
   if (lanelet_ids.empty()) {
     return ret;
   }
-  for (const auto & status : other_entity_status) {
-    for (const std::int64_t & lanelet_id : lanelet_ids) {
-      if (lanelet_id == status.second.lanelet_pose.lanelet_id) {
-        ret.emplace_back(status.second);
+  for (const std::int64_t & lanelet_id : lanelet_ids) {
+    for (const auto status : lanelet_entity_index->getEntityStatus(lanelet_id)) {
+      if (isOtherEntity(*status)) {
+        ret.emplace_back(*status);
       }
     }
   }
@@ -194,9 +217,9 @@ boost::optional<double> ActionNode::getDistanceToStopLine(
 }
 
 boost::optional<double> ActionNode::getDistanceToFrontEntity(
-  const traffic_simulator::math::CatmullRomSpline & spline)
+  const traffic_simulator::math::CatmullRomSpline & spline, double look_ahead_distance)
 {
-  auto name = getFrontEntityName(spline);
+  auto name = getFrontEntityName(spline, look_ahead_distance);
   if (!name) {
     return boost::none;
   }
@@ -204,35 +227,61 @@ boost::optional<double> ActionNode::getDistanceToFrontEntity(
 }
 
 boost::optional<std::string> ActionNode::getFrontEntityName(
-  const traffic_simulator::math::CatmullRomSpline & spline)
+  const traffic_simulator::math::CatmullRomSpline & spline, double look_ahead_distance)
 {
-  std::vector<double> distances;
-  std::vector<std::string> entities;
-  for (const auto & each : other_entity_status) {
-    const auto distance = getDistanceToTargetEntityPolygon(spline, each.first);
-    const auto quat = quaternion_operation::getRotation(
-      entity_status.pose.orientation, other_entity_status.at(each.first).pose.orientation);
+  /**
+   * @note Only entities within the look ahead distance, looked up in lanelet_entity_index, whose
+   * bounding boxes overlap the bounding box of the trajectory are candidates, so the exact
+   * collision test runs only for entities along the trajectory.
+   */
+  const auto corridor = spline.get2DBoundingBox();
+  const auto overlaps_corridor = [&](const std::vector<geometry_msgs::msg::Point> & polygon) {
+    for (const auto & point : polygon) {
+      if (
+        corridor.first.x <= point.x && point.x <= corridor.second.x &&
+        corridor.first.y <= point.y && point.y <= corridor.second.y) {
+        return true;
+      }
+    }
+    const auto x = std::minmax_element(
+      polygon.begin(), polygon.end(), [](const auto & a, const auto & b) { return a.x < b.x; });
+    const auto y = std::minmax_element(
+      polygon.begin(), polygon.end(), [](const auto & a, const auto & b) { return a.y < b.y; });
+    return x.first->x <= corridor.second.x && corridor.first.x <= x.second->x &&
+           y.first->y <= corridor.second.y && corridor.first.y <= y.second->y;
+  };
+  boost::optional<std::string> front_entity_name;
+  double front_entity_distance = look_ahead_distance;
+  // Entities are looked up by position, so the search is enlarged by the largest bounding radius.
+  for (const auto other : lanelet_entity_index->getEntityStatus(
+         entity_status.pose.position,
+         look_ahead_distance + lanelet_entity_index->getMaxBoundingRadius())) {
+    const auto & status = *other;
+    if (!status.lanelet_pose_valid || status.name == entity_status.name) {
+      continue;
+    }
+    const auto quat =
+      quaternion_operation::getRotation(entity_status.pose.orientation, status.pose.orientation);
     /**
      * @note hard-coded parameter, if the Yaw value of RPY is in ~1.5708 -> 1.5708, entity is a candidate of front entity.
      */
     if (
-      std::fabs(quaternion_operation::convertQuaternionToEulerAngle(quat).z) <=
+      std::fabs(quaternion_operation::convertQuaternionToEulerAngle(quat).z) >
       boost::math::constants::half_pi<double>()) {
-      if (distance && distance.get() < 40) {
-        entities.emplace_back(each.first);
-        distances.emplace_back(distance.get());
-      }
+      continue;
+    }
+    const auto polygon = traffic_simulator::math::transformPoints(
+      status.pose, traffic_simulator::math::getPointsFromBbox(status.bounding_box));
+    if (polygon.empty() || !overlaps_corridor(polygon)) {
+      continue;
+    }
+    const auto distance = spline.getCollisionPointIn2D(polygon, false, true);
+    if (distance && distance.get() < front_entity_distance) {
+      front_entity_name = status.name;
+      front_entity_distance = distance.get();
     }
   }
-  if (entities.size() != distances.size()) {
-    THROW_SIMULATION_ERROR("size of entities and distances vector does not match.");
-  }
-  if (distances.empty()) {
-    return boost::none;
-  }
-  std::vector<double>::iterator iter = std::min_element(distances.begin(), distances.end());
-  size_t index = std::distance(distances.begin(), iter);
-  return entities[index];
+  return front_entity_name;
 }
 
 boost::optional<double> ActionNode::getDistanceToTargetEntityOnCrosswalk(
@@ -249,8 +298,8 @@ boost::optional<double> ActionNode::getDistanceToTargetEntityOnCrosswalk(
 traffic_simulator_msgs::msg::EntityStatus ActionNode::getEntityStatus(
   const std::string target_name) const
 {
-  if (other_entity_status.find(target_name) != other_entity_status.end()) {
-    return other_entity_status.at(target_name);
+  if (other_entity_status->find(target_name) != other_entity_status->end()) {
+    return other_entity_status->at(target_name);
   }
   THROW_SIMULATION_ERROR("other entity : ", target_name, " does not exist.");
 }
@@ -314,13 +363,13 @@ ActionNode::getConflictingEntityStatusOnCrossWalk(
   const std::vector<std::int64_t> & route_lanelets) const
 {
   std::vector<traffic_simulator_msgs::msg::EntityStatus> conflicting_entity_status;
-  auto conflicting_crosswalks = hdmap_utils->getConflictingCrosswalkIds(route_lanelets);
-  for (const auto & status : other_entity_status) {
-    if (
-      std::count(
-        conflicting_crosswalks.begin(), conflicting_crosswalks.end(),
-        status.second.lanelet_pose.lanelet_id) >= 1) {
-      conflicting_entity_status.push_back(status.second);
+  const auto conflicting_crosswalks = hdmap_utils->getConflictingCrosswalkIds(route_lanelets);
+  for (const auto & lanelet_id :
+       std::set<std::int64_t>(conflicting_crosswalks.begin(), conflicting_crosswalks.end())) {
+    for (const auto status : lanelet_entity_index->getEntityStatus(lanelet_id)) {
+      if (isOtherEntity(*status)) {
+        conflicting_entity_status.push_back(*status);
+      }
     }
   }
   return conflicting_entity_status;
@@ -330,13 +379,13 @@ std::vector<traffic_simulator_msgs::msg::EntityStatus> ActionNode::getConflictin
   const std::vector<std::int64_t> & route_lanelets) const
 {
   std::vector<traffic_simulator_msgs::msg::EntityStatus> conflicting_entity_status;
-  auto conflicting_lanes = hdmap_utils->getConflictingLaneIds(route_lanelets);
-  for (const auto & status : other_entity_status) {
-    if (
-      std::count(
-        conflicting_lanes.begin(), conflicting_lanes.end(),
-        status.second.lanelet_pose.lanelet_id) >= 1) {
-      conflicting_entity_status.push_back(status.second);
+  const auto conflicting_lanes = hdmap_utils->getConflictingLaneIds(route_lanelets);
+  for (const auto & lanelet_id :
+       std::set<std::int64_t>(conflicting_lanes.begin(), conflicting_lanes.end())) {
+    for (const auto status : lanelet_entity_index->getEntityStatus(lanelet_id)) {
+      if (isOtherEntity(*status)) {
+        conflicting_entity_status.push_back(*status);
+      }
     }
   }
   return conflicting_entity_status;
@@ -344,25 +393,36 @@ std::vector<traffic_simulator_msgs::msg::EntityStatus> ActionNode::getConflictin
 
 bool ActionNode::foundConflictingEntity(const std::vector<std::int64_t> & following_lanelets) const
 {
-  auto conflicting_crosswalks = hdmap_utils->getConflictingCrosswalkIds(following_lanelets);
-  auto conflicting_lanes = hdmap_utils->getConflictingLaneIds(following_lanelets);
-  for (const auto & status : other_entity_status) {
-    if (
-      std::count(
-        conflicting_crosswalks.begin(), conflicting_crosswalks.end(),
-        status.second.lanelet_pose.lanelet_id) >= 1) {
+  for (const auto & lanelet_id : hdmap_utils->getConflictingCrosswalkIds(following_lanelets)) {
+    if (hasOtherEntityOnLanelet(lanelet_id)) {
       return true;
     }
-    if (
-      std::count(
-        conflicting_lanes.begin(), conflicting_lanes.end(),
-        status.second.lanelet_pose.lanelet_id) >= 1) {
+  }
+  for (const auto & lanelet_id : hdmap_utils->getConflictingLaneIds(following_lanelets)) {
+    if (hasOtherEntityOnLanelet(lanelet_id)) {
       return true;
     }
   }
   return false;
 }
 
+bool ActionNode::isOtherEntity(const traffic_simulator_msgs::msg::EntityStatus & status) const
+{
+  const auto p0 = status.pose.position;
+  const auto p1 = entity_status.pose.position;
+  return status.name != entity_status.name &&
+         std::sqrt(std::pow(p0.x - p1.x, 2) + std::pow(p0.y - p1.y, 2) + std::pow(p0.z - p1.z, 2)) <
+           BehaviorPluginBase::other_entity_range;
+}
+
+bool ActionNode::hasOtherEntityOnLanelet(std::int64_t lanelet_id) const
+{
+  const auto & statuses = lanelet_entity_index->getEntityStatus(lanelet_id);
+  return std::any_of(statuses.begin(), statuses.end(), [this](const auto & status) {
+    return isOtherEntity(*status);
+  });
+}
+
 double ActionNode::calculateStopDistance() const
 {
   return std::pow(entity_status.action_status.twist.linear.x, 2) / (2 * 5);
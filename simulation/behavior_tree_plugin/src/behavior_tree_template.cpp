@@ -0,0 +1,51 @@
+// Copyright 2015-2020 Tier IV, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <behavior_tree_plugin/behavior_tree_template.hpp>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+namespace entity_behavior
+{
+BehaviorTreeTemplate::BehaviorTreeTemplate(
+  const std::string & path, const NodeRegistration & register_nodes)
+: parser_(factory_)
+{
+  register_nodes(factory_);
+  parser_.loadFromFile(path);
+}
+
+auto BehaviorTreeTemplate::instantiate() -> BT::Tree
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  return parser_.instantiateTree(BT::Blackboard::create());
+}
+
+auto getBehaviorTreeTemplate(
+  const std::string & path, const BehaviorTreeTemplate::NodeRegistration & register_nodes)
+  -> BehaviorTreeTemplate &
+{
+  static std::mutex mutex;
+  static std::unordered_map<std::string, std::unique_ptr<BehaviorTreeTemplate>> templates;
+  std::lock_guard<std::mutex> lock(mutex);
+  auto iter = templates.find(path);
+  if (iter == templates.end()) {
+    auto behavior_tree_template = std::make_unique<BehaviorTreeTemplate>(path, register_nodes);
+    iter = templates.emplace(path, std::move(behavior_tree_template)).first;
+  }
+  return *iter->second;
+}
+}  // namespace entity_behavior
@@ -14,10 +14,13 @@
 
 #include <algorithm>
 #include <ament_index_cpp/get_package_share_directory.hpp>
+#include <behavior_tree_plugin/behavior_tree_template.hpp>
 #include <behavior_tree_plugin/pedestrian/behavior_tree.hpp>
+#include <cstddef>
 #include <iostream>
 #include <memory>
 #include <string>
+#include <traffic_simulator/behavior/behavior_tree_profiler.hpp>
 #include <utility>
 
 namespace entity_behavior
@@ -26,9 +29,12 @@ void PedestrianBehaviorTree::configure(const rclcpp::Logger & logger)
 {
   std::string path = ament_index_cpp::get_package_share_directory("behavior_tree_plugin") +
                      "/config/pedestrian_entity_behavior.xml";
-  factory_.registerNodeType<entity_behavior::pedestrian::FollowLaneAction>("FollowLane");
-  factory_.registerNodeType<entity_behavior::pedestrian::WalkStraightAction>("WalkStraightAction");
-  tree_ = factory_.createTreeFromFile(path);
+  tree_ = getBehaviorTreeTemplate(path, registerNodes).instantiate();
+  BT::applyRecursiveVisitor(tree_.rootNode(), [](BT::TreeNode * node) {
+    if (const auto action_node = dynamic_cast<ActionNode *>(node)) {
+      action_node->setBehaviorName("PedestrianBehaviorTree");
+    }
+  });
   logging_event_ptr_ =
     std::make_unique<behavior_tree_plugin::LoggingEvent>(tree_.rootNode(), logger);
   reset_request_event_ptr_ = std::make_unique<behavior_tree_plugin::ResetRequestEvent>(
@@ -37,6 +43,12 @@ void PedestrianBehaviorTree::configure(const rclcpp::Logger & logger)
   setRequest("none");
 }
 
+void PedestrianBehaviorTree::registerNodes(BT::BehaviorTreeFactory & factory)
+{
+  factory.registerNodeType<entity_behavior::pedestrian::FollowLaneAction>("FollowLane");
+  factory.registerNodeType<entity_behavior::pedestrian::WalkStraightAction>("WalkStraightAction");
+}
+
 const std::string & PedestrianBehaviorTree::getCurrentAction() const
 {
   return logging_event_ptr_->getCurrentAction();
@@ -44,9 +56,14 @@ const std::string & PedestrianBehaviorTree::getCurrentAction() const
 
 void PedestrianBehaviorTree::update(double current_time, double step_time)
 {
+  std::size_t ticks = 1;
   tickOnce(current_time, step_time);
   while (getCurrentAction() == "root") {
     tickOnce(current_time, step_time);
+    ticks++;
+  }
+  if (BehaviorTreeProfiler::get().enabled()) {
+    BehaviorTreeProfiler::get().addUpdate("PedestrianBehaviorTree", ticks);
   }
 }
 
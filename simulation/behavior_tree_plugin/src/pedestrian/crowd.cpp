@@ -0,0 +1,216 @@
+// Copyright 2015-2020 Tier IV, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <quaternion_operation/quaternion_operation.h>
+
+#include <algorithm>
+#include <behavior_tree_plugin/pedestrian/crowd.hpp>
+#include <boost/algorithm/clamp.hpp>
+#include <iterator>
+#include <memory>
+#include <scenario_simulator_exception/exception.hpp>
+#include <string>
+#include <vector>
+
+namespace entity_behavior
+{
+void PedestrianCrowd::configure(const rclcpp::Logger &) { request_ = "none"; }
+
+void PedestrianCrowd::update(double current_time, double step_time)
+{
+  setCurrentTime(current_time);
+  setStepTime(step_time);
+  step(*getGeometry());
+}
+
+void PedestrianCrowd::updateBatch(
+  const std::vector<BehaviorPluginBase *> & plugins, const WorldSnapshot & world)
+{
+  const auto geometry = getGeometry();
+  for (const auto plugin : plugins) {
+    const auto crowd = static_cast<PedestrianCrowd *>(plugin);
+    if (crowd->hdmap_utils_ == hdmap_utils_) {
+      crowd->geometry_ = geometry;
+    }
+    crowd->setCurrentTime(world.current_time);
+    crowd->setStepTime(world.step_time);
+    crowd->step(*crowd->getGeometry());
+  }
+}
+
+auto PedestrianCrowd::getGeometry() -> const std::shared_ptr<pedestrian::CrowdGeometry> &
+{
+  if (!hdmap_utils_) {
+    THROW_SIMULATION_ERROR("hdmap_utils of the crowd pedestrian is not set.");
+  }
+  if (!geometry_ || geometry_->getHdMapUtils() != hdmap_utils_) {
+    geometry_ = std::make_shared<pedestrian::CrowdGeometry>(hdmap_utils_);
+  }
+  return geometry_;
+}
+
+void PedestrianCrowd::step(pedestrian::CrowdGeometry & geometry)
+{
+  if (request_ == "walk_straight") {
+    current_action_ = "walk_straight";
+    updated_status_ = walkStraight(geometry);
+  } else {
+    current_action_ = "follow_lane";
+    updated_status_ = followLane(geometry);
+  }
+}
+
+auto PedestrianCrowd::calculateAccel(double target_speed) const -> double
+{
+  const double speed = entity_status_.action_status.twist.linear.x;
+  const double accel = (target_speed - speed) / step_time_;
+  if (speed > target_speed) {
+    return boost::algorithm::clamp(accel, driver_model_.deceleration * -1, 0);
+  } else {
+    return boost::algorithm::clamp(accel, 0, driver_model_.acceleration);
+  }
+}
+
+auto PedestrianCrowd::followLane(pedestrian::CrowdGeometry & geometry) const
+  -> traffic_simulator_msgs::msg::EntityStatus
+{
+  if (!entity_status_.lanelet_pose_valid) {
+    return stopAtEndOfRoad();
+  }
+  const auto & lanelet = geometry.getLanelet(entity_status_.lanelet_pose.lanelet_id);
+  geometry_msgs::msg::Accel accel_new = entity_status_.action_status.accel;
+  accel_new.linear.x = calculateAccel(target_speed_ ? target_speed_.get() : lanelet.speed_limit);
+  geometry_msgs::msg::Twist twist_new;
+  twist_new.linear.x = boost::algorithm::clamp(
+    entity_status_.action_status.twist.linear.x + accel_new.linear.x * step_time_, -10, 10);
+  std::int64_t new_lanelet_id = entity_status_.lanelet_pose.lanelet_id;
+  double new_s =
+    entity_status_.lanelet_pose.s +
+    (twist_new.linear.x + entity_status_.action_status.twist.linear.x) / 2.0 * step_time_;
+  if (new_s < 0) {
+    if (lanelet.previous.empty()) {
+      return stopAtEndOfRoad();
+    }
+    new_lanelet_id = lanelet.previous.front();
+    new_s = new_s + geometry.getLanelet(new_lanelet_id).length - 0.01;
+  } else {
+    const auto iter = std::find(route_lanelets_.begin(), route_lanelets_.end(), new_lanelet_id);
+    if (iter == route_lanelets_.end()) {
+      THROW_SIMULATION_ERROR("failed to calculate next status of the crowd pedestrian.");
+    }
+    if (lanelet.length < new_s) {
+      new_s = new_s - lanelet.length;
+      if (std::next(iter) != route_lanelets_.end()) {
+        new_lanelet_id = *std::next(iter);
+      } else if (lanelet.next.empty()) {
+        return stopAtEndOfRoad();
+      } else {
+        new_lanelet_id = lanelet.next.front();
+      }
+    }
+  }
+  traffic_simulator_msgs::msg::EntityStatus entity_status_updated;
+  entity_status_updated.time = current_time_ + step_time_;
+  entity_status_updated.lanelet_pose.lanelet_id = new_lanelet_id;
+  entity_status_updated.lanelet_pose.s = new_s;
+  entity_status_updated.lanelet_pose.offset = entity_status_.lanelet_pose.offset;
+  entity_status_updated.lanelet_pose.rpy = entity_status_.lanelet_pose.rpy;
+  entity_status_updated.pose = hdmap_utils_->toMapPose(entity_status_updated.lanelet_pose).pose;
+  entity_status_updated.action_status.twist = twist_new;
+  entity_status_updated.action_status.accel = accel_new;
+  return entity_status_updated;
+}
+
+auto PedestrianCrowd::walkStraight(pedestrian::CrowdGeometry & geometry) const
+  -> traffic_simulator_msgs::msg::EntityStatus
+{
+  geometry_msgs::msg::Accel accel_new = entity_status_.action_status.accel;
+  accel_new.linear.x = calculateAccel(target_speed_ ? target_speed_.get() : 1.111);
+  const auto & twist = entity_status_.action_status.twist;
+  geometry_msgs::msg::Twist twist_new;
+  twist_new.linear.x = twist.linear.x + accel_new.linear.x * step_time_;
+  twist_new.linear.y = twist.linear.y + accel_new.linear.y * step_time_;
+  twist_new.linear.z = twist.linear.z + accel_new.linear.z * step_time_;
+  twist_new.angular.x = twist.angular.x + accel_new.angular.x * step_time_;
+  twist_new.angular.y = twist.angular.y + accel_new.angular.y * step_time_;
+  twist_new.angular.z = twist.angular.z + accel_new.angular.z * step_time_;
+  geometry_msgs::msg::Vector3 angular_trans_vec;
+  angular_trans_vec.z = twist_new.angular.z * step_time_;
+  geometry_msgs::msg::Pose pose_new;
+  pose_new.orientation = quaternion_operation::rotation(
+    entity_status_.pose.orientation,
+    quaternion_operation::convertEulerAngleToQuaternion(angular_trans_vec));
+  Eigen::Vector3d trans_vec(twist_new.linear.x * step_time_, twist_new.linear.y * step_time_, 0);
+  trans_vec = quaternion_operation::getRotationMatrix(pose_new.orientation) * trans_vec;
+  pose_new.position.x = trans_vec(0) + entity_status_.pose.position.x;
+  pose_new.position.y = trans_vec(1) + entity_status_.pose.position.y;
+  pose_new.position.z = trans_vec(2) + entity_status_.pose.position.z;
+  traffic_simulator_msgs::msg::EntityStatus entity_status_updated;
+  entity_status_updated.time = current_time_ + step_time_;
+  entity_status_updated.pose = pose_new;
+  entity_status_updated.action_status.twist = twist_new;
+  entity_status_updated.action_status.accel = accel_new;
+  const auto lanelet_pose = matchToLanelet(geometry, pose_new);
+  if (lanelet_pose) {
+    entity_status_updated.lanelet_pose_valid = true;
+    entity_status_updated.lanelet_pose = lanelet_pose.get();
+  } else {
+    entity_status_updated.lanelet_pose_valid = false;
+  }
+  return entity_status_updated;
+}
+
+/**
+ * @note Tries the current lanelet and its neighbors before falling back to the search over the
+ * whole map, because a walking pedestrian rarely leaves them within a frame.
+ */
+auto PedestrianCrowd::matchToLanelet(
+  pedestrian::CrowdGeometry & geometry, const geometry_msgs::msg::Pose & pose) const
+  -> boost::optional<traffic_simulator_msgs::msg::LaneletPose>
+{
+  if (entity_status_.lanelet_pose_valid) {
+    const auto lanelet_id = entity_status_.lanelet_pose.lanelet_id;
+    if (const auto lanelet_pose = hdmap_utils_->toLaneletPose(pose, lanelet_id, 1.0)) {
+      return lanelet_pose;
+    }
+    const auto & lanelet = geometry.getLanelet(lanelet_id);
+    for (const auto ids : {&lanelet.next, &lanelet.previous}) {
+      for (const auto id : *ids) {
+        if (const auto lanelet_pose = hdmap_utils_->toLaneletPose(pose, id, 1.0)) {
+          return lanelet_pose;
+        }
+      }
+    }
+  } else {
+    const auto lanelet_pose = hdmap_utils_->toLaneletPose(pose, entity_status_.bounding_box, true);
+    if (lanelet_pose) {
+      return lanelet_pose;
+    }
+  }
+  return hdmap_utils_->toLaneletPose(pose, true, 2.0);
+}
+
+auto PedestrianCrowd::stopAtEndOfRoad() const -> traffic_simulator_msgs::msg::EntityStatus
+{
+  traffic_simulator_msgs::msg::EntityStatus entity_status_updated = entity_status_;
+  entity_status_updated.time = current_time_ + step_time_;
+  entity_status_updated.action_status.twist = geometry_msgs::msg::Twist();
+  entity_status_updated.action_status.accel = geometry_msgs::msg::Accel();
+  return entity_status_updated;
+}
+}  // namespace entity_behavior
+
+#include "pluginlib/class_list_macros.hpp"
+
+PLUGINLIB_EXPORT_CLASS(entity_behavior::PedestrianCrowd, entity_behavior::BehaviorPluginBase)
@@ -0,0 +1,44 @@
+// Copyright 2015-2020 Tier IV, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <behavior_tree_plugin/pedestrian/crowd_geometry.hpp>
+#include <memory>
+#include <unordered_map>
+#include <utility>
+
+namespace entity_behavior
+{
+namespace pedestrian
+{
+CrowdGeometry::CrowdGeometry(const std::shared_ptr<hdmap_utils::HdMapUtils> & hdmap_utils)
+: hdmap_utils_(hdmap_utils)
+{
+}
+
+auto CrowdGeometry::getLanelet(std::int64_t lanelet_id) -> const Lanelet &
+{
+  auto iter = lanelets_.find(lanelet_id);
+  if (iter == lanelets_.end()) {
+    Lanelet lanelet;
+    lanelet.length = hdmap_utils_->getLaneletLength(lanelet_id);
+    lanelet.speed_limit =
+      hdmap_utils_->getSpeedLimit(hdmap_utils_->getFollowingLanelets(lanelet_id));
+    lanelet.previous = hdmap_utils_->getPreviousLaneletIds(lanelet_id);
+    lanelet.next = hdmap_utils_->getNextLaneletIds(lanelet_id);
+    iter = lanelets_.emplace(lanelet_id, std::move(lanelet)).first;
+  }
+  return iter->second;
+}
+}  // namespace pedestrian
+}  // namespace entity_behavior
@@ -79,18 +79,18 @@ traffic_simulator_msgs::msg::EntityStatus PedestrianActionNode::calculateEntityS
     return entity_status_updated;
   } else {
     bool calculation_success = false;
-    for (size_t i = 0; i < route_lanelets.size(); i++) {
-      if (route_lanelets[i] == entity_status.lanelet_pose.lanelet_id) {
+    for (size_t i = 0; i < route_lanelets->size(); i++) {
+      if ((*route_lanelets)[i] == entity_status.lanelet_pose.lanelet_id) {
         double length = hdmap_utils->getLaneletLength(entity_status.lanelet_pose.lanelet_id);
         calculation_success = true;
         if (length < new_s) {
-          if (i != (route_lanelets.size() - 1)) {
+          if (i != (route_lanelets->size() - 1)) {
             new_s = new_s - length;
-            new_lanelet_id = route_lanelets[i + 1];
+            new_lanelet_id = (*route_lanelets)[i + 1];
             break;
           } else {
             new_s = new_s - length;
-            auto next_ids = hdmap_utils->getNextLaneletIds(route_lanelets[i]);
+            auto next_ids = hdmap_utils->getNextLaneletIds((*route_lanelets)[i]);
             if (next_ids.empty()) {
               return stopAtEndOfRoad();
             }
@@ -14,6 +14,7 @@
 
 #include <algorithm>
 #include <ament_index_cpp/get_package_share_directory.hpp>
+#include <behavior_tree_plugin/behavior_tree_template.hpp>
 #include <behavior_tree_plugin/vehicle/behavior_tree.hpp>
 #include <behavior_tree_plugin/vehicle/follow_lane_sequence/follow_front_entity_action.hpp>
 #include <behavior_tree_plugin/vehicle/follow_lane_sequence/follow_lane_action.hpp>
@@ -23,10 +24,15 @@
 #include <behavior_tree_plugin/vehicle/follow_lane_sequence/stop_at_traffic_light_action.hpp>
 #include <behavior_tree_plugin/vehicle/follow_lane_sequence/yield_action.hpp>
 #include <behavior_tree_plugin/vehicle/lane_change_action.hpp>
+#include <behavior_tree_plugin/vehicle/route_context.hpp>
+#include <cstddef>
 #include <iostream>
+#include <memory>
 #include <string>
+#include <traffic_simulator/behavior/behavior_tree_profiler.hpp>
 #include <traffic_simulator_msgs/msg/driver_model.hpp>
 #include <utility>
+#include <vector>
 
 namespace entity_behavior
 {
@@ -34,31 +40,40 @@ void VehicleBehaviorTree::configure(const rclcpp::Logger & logger)
 {
   std::string path = ament_index_cpp::get_package_share_directory("behavior_tree_plugin") +
                      "/config/vehicle_entity_behavior.xml";
-  factory_.registerNodeType<entity_behavior::vehicle::follow_lane_sequence::FollowLaneAction>(
+  tree_ = getBehaviorTreeTemplate(path, registerNodes).instantiate();
+  BT::applyRecursiveVisitor(tree_.rootNode(), [](BT::TreeNode * node) {
+    if (const auto action_node = dynamic_cast<ActionNode *>(node)) {
+      action_node->setBehaviorName("VehicleBehaviorTree");
+    }
+  });
+
+  logging_event_ptr_ =
+    std::make_unique<behavior_tree_plugin::LoggingEvent>(tree_.rootNode(), logger);
+  reset_request_event_ptr_ = std::make_unique<behavior_tree_plugin::ResetRequestEvent>(
+    tree_.rootNode(), [&]() { return getRequest(); },
+    [&](std::string request) { return setRequest(request); });
+  setRequest("none");
+}
+
+void VehicleBehaviorTree::registerNodes(BT::BehaviorTreeFactory & factory)
+{
+  factory.registerNodeType<entity_behavior::vehicle::follow_lane_sequence::FollowLaneAction>(
     "FollowLane");
-  factory_
+  factory
     .registerNodeType<entity_behavior::vehicle::follow_lane_sequence::FollowFrontEntityAction>(
       "FollowFrontEntity");
-  factory_
+  factory
     .registerNodeType<entity_behavior::vehicle::follow_lane_sequence::StopAtCrossingEntityAction>(
       "StopAtCrossingEntity");
-  factory_.registerNodeType<entity_behavior::vehicle::follow_lane_sequence::StopAtStopLineAction>(
+  factory.registerNodeType<entity_behavior::vehicle::follow_lane_sequence::StopAtStopLineAction>(
     "StopAtStopLine");
-  factory_
+  factory
     .registerNodeType<entity_behavior::vehicle::follow_lane_sequence::StopAtTrafficLightAction>(
       "StopAtTrafficLight");
-  factory_.registerNodeType<entity_behavior::vehicle::follow_lane_sequence::YieldAction>("Yield");
-  factory_.registerNodeType<entity_behavior::vehicle::follow_lane_sequence::MoveBackwardAction>(
+  factory.registerNodeType<entity_behavior::vehicle::follow_lane_sequence::YieldAction>("Yield");
+  factory.registerNodeType<entity_behavior::vehicle::follow_lane_sequence::MoveBackwardAction>(
     "MoveBackward");
-  factory_.registerNodeType<entity_behavior::vehicle::LaneChangeAction>("LaneChange");
-  tree_ = factory_.createTreeFromFile(path);
-
-  logging_event_ptr_ =
-    std::make_unique<behavior_tree_plugin::LoggingEvent>(tree_.rootNode(), logger);
-  reset_request_event_ptr_ = std::make_unique<behavior_tree_plugin::ResetRequestEvent>(
-    tree_.rootNode(), [&]() { return getRequest(); },
-    [&](std::string request) { return setRequest(request); });
-  setRequest("none");
+  factory.registerNodeType<entity_behavior::vehicle::LaneChangeAction>("LaneChange");
 }
 
 const std::string & VehicleBehaviorTree::getCurrentAction() const
@@ -68,9 +83,38 @@ const std::string & VehicleBehaviorTree::getCurrentAction() const
 
 void VehicleBehaviorTree::update(double current_time, double step_time)
 {
+  updateRouteContext();
+  std::size_t ticks = 1;
   tickOnce(current_time, step_time);
   while (getCurrentAction() == "root") {
     tickOnce(current_time, step_time);
+    ticks++;
+  }
+  if (BehaviorTreeProfiler::get().enabled()) {
+    BehaviorTreeProfiler::get().addUpdate("VehicleBehaviorTree", ticks);
+  }
+}
+
+void VehicleBehaviorTree::updateRouteContext()
+{
+  using RouteSpline = std::shared_ptr<const traffic_simulator::math::CatmullRomSpline>;
+  using RouteContextPtr = std::shared_ptr<const RouteContext>;
+  const auto route_lanelets =
+    tree_.rootBlackboard()->get<std::shared_ptr<const std::vector<std::int64_t>>>(
+      getRouteLaneletsKey());
+  if (route_lanelets->empty()) {
+    route_context_lanelets_.clear();
+    tree_.rootBlackboard()->set<RouteSpline>("route_spline", nullptr);
+    tree_.rootBlackboard()->set<RouteContextPtr>("route_context", nullptr);
+  } else if (*route_lanelets != route_context_lanelets_) {
+    route_context_lanelets_ = *route_lanelets;
+    const auto hdmap_utils = getHdMapUtils();
+    const auto route_spline = std::make_shared<const traffic_simulator::math::CatmullRomSpline>(
+      hdmap_utils->getCenterPoints(route_context_lanelets_));
+    tree_.rootBlackboard()->set<RouteSpline>("route_spline", route_spline);
+    tree_.rootBlackboard()->set<RouteContextPtr>(
+      "route_context",
+      std::make_shared<const RouteContext>(hdmap_utils, route_context_lanelets_));
   }
 }
 
@@ -61,7 +61,7 @@ const traffic_simulator_msgs::msg::WaypointsArray FollowFrontEntityAction::calcu
     traffic_simulator_msgs::msg::WaypointsArray waypoints;
     double horizon =
       boost::algorithm::clamp(entity_status.action_status.twist.linear.x * 5, 20, 50);
-    traffic_simulator::math::CatmullRomSpline spline(hdmap_utils->getCenterPoints(route_lanelets));
+    const auto & spline = getRouteSpline();
     waypoints.waypoints = spline.getTrajectory(
       entity_status.lanelet_pose.s, entity_status.lanelet_pose.s + horizon, 1.0,
       entity_status.lanelet_pose.offset);
@@ -77,7 +77,7 @@ BT::NodeStatus FollowFrontEntityAction::tick()
   if (request != "none" && request != "follow_lane") {
     return BT::NodeStatus::FAILURE;
   }
-  if (getRightOfWayEntities(route_lanelets).size() != 0) {
+  if (hasRightOfWayEntitiesOnRoute()) {
     return BT::NodeStatus::FAILURE;
   }
   if (!driver_model.see_around) {
@@ -87,11 +87,12 @@ BT::NodeStatus FollowFrontEntityAction::tick()
   if (waypoints.waypoints.empty()) {
     return BT::NodeStatus::FAILURE;
   }
-  auto distance_to_stopline =
-    hdmap_utils->getDistanceToStopLine(route_lanelets, waypoints.waypoints);
+  auto distance_to_stopline = getRouteContext().getDistanceToStopLine(
+    entity_status.lanelet_pose, getHorizon(), waypoints.waypoints);
   const auto spline = traffic_simulator::math::CatmullRomSpline(waypoints.waypoints);
-  auto distance_to_conflicting_entity = getDistanceToConflictingEntity(route_lanelets, spline);
-  const auto front_entity_name = getFrontEntityName(spline);
+  auto distance_to_conflicting_entity = getDistanceToConflictingEntity(*route_lanelets, spline);
+  const auto front_entity_name =
+    getFrontEntityName(spline, driver_model.front_entity_look_ahead_distance);
   if (!front_entity_name) {
     return BT::NodeStatus::FAILURE;
   }
@@ -111,7 +112,7 @@ BT::NodeStatus FollowFrontEntityAction::tick()
   }
   auto front_entity_status = getEntityStatus(front_entity_name.get());
   if (!target_speed) {
-    target_speed = hdmap_utils->getSpeedLimit(route_lanelets);
+    target_speed = getRouteContext().getSpeedLimit();
   }
   if (target_speed.get() <= front_entity_status.action_status.twist.linear.x) {
     auto entity_status_updated = calculateEntityStatusUpdated(target_speed.get());
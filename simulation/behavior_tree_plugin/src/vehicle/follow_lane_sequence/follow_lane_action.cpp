@@ -44,7 +44,7 @@ const traffic_simulator_msgs::msg::WaypointsArray FollowLaneAction::calculateWay
   }
   if (entity_status.action_status.twist.linear.x >= 0) {
     traffic_simulator_msgs::msg::WaypointsArray waypoints;
-    traffic_simulator::math::CatmullRomSpline spline(hdmap_utils->getCenterPoints(route_lanelets));
+    const auto & spline = getRouteSpline();
     waypoints.waypoints = spline.getTrajectory(
       entity_status.lanelet_pose.s, entity_status.lanelet_pose.s + getHorizon(), 1.0,
       entity_status.lanelet_pose.offset);
@@ -81,11 +81,12 @@ BT::NodeStatus FollowLaneAction::tick()
     return BT::NodeStatus::FAILURE;
   }
   if (driver_model.see_around) {
-    if (getRightOfWayEntities(route_lanelets).size() != 0) {
+    if (hasRightOfWayEntitiesOnRoute()) {
       return BT::NodeStatus::FAILURE;
     }
     const auto spline = traffic_simulator::math::CatmullRomSpline(waypoints.waypoints);
-    auto distance_to_front_entity = getDistanceToFrontEntity(spline);
+    auto distance_to_front_entity =
+      getDistanceToFrontEntity(spline, driver_model.front_entity_look_ahead_distance);
     if (distance_to_front_entity) {
       if (
         distance_to_front_entity.get() <=
@@ -94,15 +95,16 @@ BT::NodeStatus FollowLaneAction::tick()
       }
     }
     const auto distance_to_traffic_stop_line =
-      getDistanceToTrafficLightStopLine(route_lanelets, waypoints.waypoints);
+      getRouteContext().getDistanceToTrafficLightStopLine(
+        entity_status.lanelet_pose, getHorizon(), waypoints.waypoints, *traffic_light_manager);
     if (distance_to_traffic_stop_line) {
       if (distance_to_traffic_stop_line.get() <= getHorizon()) {
         return BT::NodeStatus::FAILURE;
       }
     }
-    auto distance_to_stopline =
-      hdmap_utils->getDistanceToStopLine(route_lanelets, waypoints.waypoints);
-    auto distance_to_conflicting_entity = getDistanceToConflictingEntity(route_lanelets, spline);
+    auto distance_to_stopline = getRouteContext().getDistanceToStopLine(
+      entity_status.lanelet_pose, getHorizon(), waypoints.waypoints);
+    auto distance_to_conflicting_entity = getDistanceToConflictingEntity(*route_lanelets, spline);
     if (distance_to_stopline) {
       if (
         distance_to_stopline.get() <=
@@ -119,7 +121,7 @@ BT::NodeStatus FollowLaneAction::tick()
     }
   }
   if (!target_speed) {
-    target_speed = hdmap_utils->getSpeedLimit(route_lanelets);
+    target_speed = getRouteContext().getSpeedLimit();
   }
   auto updated_status = calculateEntityStatusUpdated(target_speed.get());
   setOutput("updated_status", updated_status);
@@ -60,7 +60,7 @@ const traffic_simulator_msgs::msg::WaypointsArray StopAtCrossingEntityAction::ca
   }
   if (entity_status.action_status.twist.linear.x >= 0) {
     traffic_simulator_msgs::msg::WaypointsArray waypoints;
-    traffic_simulator::math::CatmullRomSpline spline(hdmap_utils->getCenterPoints(route_lanelets));
+    const auto & spline = getRouteSpline();
     waypoints.waypoints = spline.getTrajectory(
       entity_status.lanelet_pose.s, entity_status.lanelet_pose.s + getHorizon(), 1.0,
       entity_status.lanelet_pose.offset);
@@ -102,7 +102,7 @@ BT::NodeStatus StopAtCrossingEntityAction::tick()
     in_stop_sequence_ = false;
     return BT::NodeStatus::FAILURE;
   }
-  if (getRightOfWayEntities(route_lanelets).size() != 0) {
+  if (hasRightOfWayEntitiesOnRoute()) {
     in_stop_sequence_ = false;
     return BT::NodeStatus::FAILURE;
   }
@@ -111,10 +111,11 @@ BT::NodeStatus StopAtCrossingEntityAction::tick()
     return BT::NodeStatus::FAILURE;
   }
   const auto spline = traffic_simulator::math::CatmullRomSpline(waypoints.waypoints);
-  distance_to_stop_target_ = getDistanceToConflictingEntity(route_lanelets, spline);
-  auto distance_to_stopline =
-    hdmap_utils->getDistanceToStopLine(route_lanelets, waypoints.waypoints);
-  const auto distance_to_front_entity = getDistanceToFrontEntity(spline);
+  distance_to_stop_target_ = getDistanceToConflictingEntity(*route_lanelets, spline);
+  auto distance_to_stopline = getRouteContext().getDistanceToStopLine(
+    entity_status.lanelet_pose, getHorizon(), waypoints.waypoints);
+  const auto distance_to_front_entity =
+    getDistanceToFrontEntity(spline, driver_model.front_entity_look_ahead_distance);
   if (!distance_to_stop_target_) {
     in_stop_sequence_ = false;
     return BT::NodeStatus::FAILURE;
@@ -62,7 +62,7 @@ const traffic_simulator_msgs::msg::WaypointsArray StopAtStopLineAction::calculat
     traffic_simulator_msgs::msg::WaypointsArray waypoints;
     double horizon =
       boost::algorithm::clamp(entity_status.action_status.twist.linear.x * 5, 20, 50);
-    traffic_simulator::math::CatmullRomSpline spline(hdmap_utils->getCenterPoints(route_lanelets));
+    const auto & spline = getRouteSpline();
     waypoints.waypoints = spline.getTrajectory(
       entity_status.lanelet_pose.s, entity_status.lanelet_pose.s + horizon, 1.0,
       entity_status.lanelet_pose.offset);
@@ -99,17 +99,19 @@ BT::NodeStatus StopAtStopLineAction::tick()
   if (!driver_model.see_around) {
     return BT::NodeStatus::FAILURE;
   }
-  if (getRightOfWayEntities(route_lanelets).size() != 0) {
+  if (hasRightOfWayEntitiesOnRoute()) {
     return BT::NodeStatus::FAILURE;
   }
   const auto waypoints = calculateWaypoints();
   if (waypoints.waypoints.empty()) {
     return BT::NodeStatus::FAILURE;
   }
-  distance_to_stopline_ = hdmap_utils->getDistanceToStopLine(route_lanelets, waypoints.waypoints);
+  distance_to_stopline_ = getRouteContext().getDistanceToStopLine(
+    entity_status.lanelet_pose, getHorizon(), waypoints.waypoints);
   const auto spline = traffic_simulator::math::CatmullRomSpline(waypoints.waypoints);
-  const auto distance_to_stop_target = getDistanceToConflictingEntity(route_lanelets, spline);
-  const auto distance_to_front_entity = getDistanceToFrontEntity(spline);
+  const auto distance_to_stop_target = getDistanceToConflictingEntity(*route_lanelets, spline);
+  const auto distance_to_front_entity =
+    getDistanceToFrontEntity(spline, driver_model.front_entity_look_ahead_distance);
   if (!distance_to_stopline_) {
     stopped_ = false;
     return BT::NodeStatus::FAILURE;
@@ -136,7 +138,7 @@ BT::NodeStatus StopAtStopLineAction::tick()
   }
   if (stopped_) {
     if (!target_speed) {
-      target_speed = hdmap_utils->getSpeedLimit(route_lanelets);
+      target_speed = getRouteContext().getSpeedLimit();
     }
     if (!distance_to_stopline_) {
       stopped_ = false;
@@ -59,7 +59,7 @@ const traffic_simulator_msgs::msg::WaypointsArray StopAtTrafficLightAction::calc
   }
   if (entity_status.action_status.twist.linear.x >= 0) {
     traffic_simulator_msgs::msg::WaypointsArray waypoints;
-    traffic_simulator::math::CatmullRomSpline spline(hdmap_utils->getCenterPoints(route_lanelets));
+    const auto & spline = getRouteSpline();
     waypoints.waypoints = spline.getTrajectory(
       entity_status.lanelet_pose.s, entity_status.lanelet_pose.s + getHorizon(), 1.0,
       entity_status.lanelet_pose.offset);
@@ -98,7 +98,7 @@ BT::NodeStatus StopAtTrafficLightAction::tick()
   if (!driver_model.see_around) {
     return BT::NodeStatus::FAILURE;
   }
-  if (getRightOfWayEntities(route_lanelets).size() != 0) {
+  if (hasRightOfWayEntitiesOnRoute()) {
     return BT::NodeStatus::FAILURE;
   }
   const auto waypoints = calculateWaypoints();
@@ -106,12 +106,13 @@ BT::NodeStatus StopAtTrafficLightAction::tick()
     return BT::NodeStatus::FAILURE;
   }
   const auto spline = traffic_simulator::math::CatmullRomSpline(waypoints.waypoints);
-  const auto distance_to_traffic_stop_line =
-    hdmap_utils->getDistanceToTrafficLightStopLine(route_lanelets, waypoints.waypoints);
+  const auto distance_to_traffic_stop_line = getRouteContext().getDistanceToTrafficLightStopLine(
+    entity_status.lanelet_pose, getHorizon(), waypoints.waypoints);
   if (!distance_to_traffic_stop_line) {
     return BT::NodeStatus::FAILURE;
   }
-  distance_to_stop_target_ = getDistanceToTrafficLightStopLine(route_lanelets, waypoints.waypoints);
+  distance_to_stop_target_ = getRouteContext().getDistanceToTrafficLightStopLine(
+    entity_status.lanelet_pose, getHorizon(), waypoints.waypoints, *traffic_light_manager);
   boost::optional<double> target_linear_speed;
   if (distance_to_stop_target_) {
     if (distance_to_stop_target_.get() > getHorizon()) {
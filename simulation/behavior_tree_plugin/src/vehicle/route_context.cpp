@@ -0,0 +1,169 @@
+// Copyright 2015-2020 Tier IV, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <behavior_tree_plugin/vehicle/route_context.hpp>
+#include <limits>
+#include <memory>
+#include <set>
+#include <utility>
+#include <vector>
+
+namespace entity_behavior
+{
+RouteContext::RouteContext(
+  const std::shared_ptr<hdmap_utils::HdMapUtils> & hdmap_utils,
+  const std::vector<std::int64_t> & route_lanelets)
+: hdmap_utils_(hdmap_utils),
+  route_lanelets_(route_lanelets),
+  speed_limit_(hdmap_utils->getSpeedLimit(route_lanelets)),
+  right_of_way_lanelet_ids_(hdmap_utils->getRightOfWayLaneletIds(route_lanelets))
+{
+  double s = 0;
+  for (const auto lanelet_id : route_lanelets_) {
+    lanelet_start_s_.emplace(lanelet_id, s);
+    s = s + hdmap_utils_->getLaneletLength(lanelet_id);
+  }
+  for (const auto & stop_line : hdmap_utils_->getStopLinesPointsOnPath(route_lanelets_)) {
+    const auto collision_point = getCollisionPoint(stop_line);
+    if (collision_point) {
+      stop_line_s_.emplace_back(collision_point.get());
+    }
+  }
+  std::sort(stop_line_s_.begin(), stop_line_s_.end());
+  for (const auto id : hdmap_utils_->getTrafficLightIdsOnPath(route_lanelets_)) {
+    for (const auto & stop_line : hdmap_utils_->getTrafficLightStopLinesPoints(id)) {
+      const auto collision_point = getCollisionPoint(stop_line);
+      if (collision_point) {
+        traffic_light_stop_line_s_.emplace_back(collision_point.get(), id);
+        break;
+      }
+    }
+  }
+  std::sort(traffic_light_stop_line_s_.begin(), traffic_light_stop_line_s_.end());
+}
+
+auto RouteContext::getCollisionPoint(const std::vector<geometry_msgs::msg::Point> & line) const
+  -> boost::optional<double>
+{
+  for (const auto lanelet_id : route_lanelets_) {
+    const auto s = hdmap_utils_->getCenterPointsSpline(lanelet_id)->getCollisionPointIn2D(line);
+    if (s) {
+      return lanelet_start_s_.at(lanelet_id) + s.get();
+    }
+  }
+  return boost::none;
+}
+
+auto RouteContext::getRightOfWayLaneletIds(std::int64_t lanelet_id) const
+  -> const std::vector<std::int64_t> &
+{
+  static const std::vector<std::int64_t> empty;
+  const auto iter = right_of_way_lanelet_ids_.find(lanelet_id);
+  return iter == right_of_way_lanelet_ids_.end() ? empty : iter->second;
+}
+
+auto RouteContext::getS(const traffic_simulator_msgs::msg::LaneletPose & pose) const
+  -> boost::optional<double>
+{
+  const auto iter = lanelet_start_s_.find(pose.lanelet_id);
+  if (iter == lanelet_start_s_.end()) {
+    return boost::none;
+  }
+  return iter->second + pose.s;
+}
+
+auto RouteContext::getLongitudinalDistance(
+  const traffic_simulator_msgs::msg::LaneletPose & from, std::int64_t to_lanelet_id) const
+  -> boost::optional<double>
+{
+  const auto from_s = getS(from);
+  const auto iter = lanelet_start_s_.find(to_lanelet_id);
+  if (!from_s || iter == lanelet_start_s_.end() || iter->second < from_s.get()) {
+    return boost::none;
+  }
+  return iter->second - from_s.get();
+}
+
+auto RouteContext::getDistanceToStopLine(
+  const traffic_simulator_msgs::msg::LaneletPose & from, double horizon,
+  const std::vector<geometry_msgs::msg::Point> & waypoints) const -> boost::optional<double>
+{
+  const auto s = getS(from);
+  if (!s) {
+    return hdmap_utils_->getDistanceToStopLine(route_lanelets_, waypoints);
+  }
+  const auto iter = std::lower_bound(stop_line_s_.begin(), stop_line_s_.end(), s.get());
+  if (iter == stop_line_s_.end() || s.get() + horizon < *iter) {
+    return boost::none;
+  }
+  return *iter - s.get();
+}
+
+auto RouteContext::getDistanceToTrafficLightStopLine(
+  const traffic_simulator_msgs::msg::LaneletPose & from, double horizon,
+  const std::vector<geometry_msgs::msg::Point> & waypoints) const -> boost::optional<double>
+{
+  const auto s = getS(from);
+  if (!s) {
+    return hdmap_utils_->getDistanceToTrafficLightStopLine(route_lanelets_, waypoints);
+  }
+  const auto iter = std::lower_bound(
+    traffic_light_stop_line_s_.begin(), traffic_light_stop_line_s_.end(),
+    std::make_pair(s.get(), std::numeric_limits<std::int64_t>::min()));
+  if (iter == traffic_light_stop_line_s_.end() || s.get() + horizon < iter->first) {
+    return boost::none;
+  }
+  return iter->first - s.get();
+}
+
+auto RouteContext::getDistanceToTrafficLightStopLine(
+  const traffic_simulator_msgs::msg::LaneletPose & from, double horizon,
+  const std::vector<geometry_msgs::msg::Point> & waypoints,
+  traffic_simulator::TrafficLightManagerBase & traffic_light_manager) const
+  -> boost::optional<double>
+{
+  const auto s = getS(from);
+  if (!s) {
+    std::set<double> collision_points;
+    for (const auto id : hdmap_utils_->getTrafficLightIdsOnPath(route_lanelets_)) {
+      const auto color = traffic_light_manager.getColor(id);
+      if (
+        color == traffic_simulator::TrafficLightColor::RED ||
+        color == traffic_simulator::TrafficLightColor::YELLOW) {
+        const auto collision_point = hdmap_utils_->getDistanceToTrafficLightStopLine(waypoints, id);
+        if (collision_point) {
+          collision_points.insert(collision_point.get());
+        }
+      }
+    }
+    if (collision_points.empty()) {
+      return boost::none;
+    }
+    return *collision_points.begin();
+  }
+  for (auto iter = std::lower_bound(
+         traffic_light_stop_line_s_.begin(), traffic_light_stop_line_s_.end(),
+         std::make_pair(s.get(), std::numeric_limits<std::int64_t>::min()));
+       iter != traffic_light_stop_line_s_.end() && iter->first <= s.get() + horizon; ++iter) {
+    const auto color = traffic_light_manager.getColor(iter->second);
+    if (
+      color == traffic_simulator::TrafficLightColor::RED ||
+      color == traffic_simulator::TrafficLightColor::YELLOW) {
+      return iter->first - s.get();
+    }
+  }
+  return boost::none;
+}
+}  // namespace entity_behavior
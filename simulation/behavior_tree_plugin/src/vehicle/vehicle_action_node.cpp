@@ -36,6 +36,59 @@ void VehicleActionNode::getBlackBoardValues()
         "vehicle_parameters", vehicle_parameters)) {
     THROW_SIMULATION_ERROR("failed to get input vehicle_parameters in VehicleActionNode");
   }
+  if (!getInput<std::shared_ptr<const traffic_simulator::math::CatmullRomSpline>>(
+        "route_spline", route_spline)) {
+    THROW_SIMULATION_ERROR("failed to get input route_spline in VehicleActionNode");
+  }
+  if (!getInput<std::shared_ptr<const RouteContext>>("route_context", route_context)) {
+    THROW_SIMULATION_ERROR("failed to get input route_context in VehicleActionNode");
+  }
+}
+
+auto VehicleActionNode::getRouteSpline() const -> const traffic_simulator::math::CatmullRomSpline &
+{
+  if (!route_spline) {
+    THROW_SIMULATION_ERROR("route spline is empty, because route_lanelets is empty");
+  }
+  return *route_spline;
+}
+
+auto VehicleActionNode::getRouteContext() const -> const RouteContext &
+{
+  if (!route_context) {
+    THROW_SIMULATION_ERROR("route context is empty, because route_lanelets is empty");
+  }
+  return *route_context;
+}
+
+auto VehicleActionNode::hasRightOfWayEntitiesOnRoute() const -> bool
+{
+  const auto & context = getRouteContext();
+  for (const auto lanelet_id : context.getRouteLanelets()) {
+    for (const auto right_of_way_id : context.getRightOfWayLaneletIds(lanelet_id)) {
+      if (hasOtherEntityOnLanelet(right_of_way_id)) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+auto VehicleActionNode::getYieldStopDistanceOnRoute() const -> boost::optional<double>
+{
+  const auto & context = getRouteContext();
+  for (const auto lanelet_id : context.getRouteLanelets()) {
+    for (const auto right_of_way_id : context.getRightOfWayLaneletIds(lanelet_id)) {
+      if (hasOtherEntityOnLanelet(right_of_way_id)) {
+        const auto distance =
+          context.getLongitudinalDistance(entity_status.lanelet_pose, lanelet_id);
+        if (distance) {
+          return distance;
+        }
+      }
+    }
+  }
+  return boost::none;
 }
 
 traffic_simulator_msgs::msg::EntityStatus VehicleActionNode::calculateEntityStatusUpdated(
@@ -80,18 +133,18 @@ traffic_simulator_msgs::msg::EntityStatus VehicleActionNode::calculateEntityStat
     return entity_status_updated;
   } else {
     bool calculation_success = false;
-    for (size_t i = 0; i < route_lanelets.size(); i++) {
-      if (route_lanelets[i] == entity_status.lanelet_pose.lanelet_id) {
+    for (size_t i = 0; i < route_lanelets->size(); i++) {
+      if ((*route_lanelets)[i] == entity_status.lanelet_pose.lanelet_id) {
         double length = hdmap_utils->getLaneletLength(entity_status.lanelet_pose.lanelet_id);
         calculation_success = true;
         if (length < new_s) {
-          if (i != (route_lanelets.size() - 1)) {
+          if (i != (route_lanelets->size() - 1)) {
             new_s = new_s - length;
-            new_lanelet_id = route_lanelets[i + 1];
+            new_lanelet_id = (*route_lanelets)[i + 1];
             break;
           } else {
             new_s = new_s - length;
-            auto next_ids = hdmap_utils->getNextLaneletIds(route_lanelets[i]);
+            auto next_ids = hdmap_utils->getNextLaneletIds((*route_lanelets)[i]);
             if (next_ids.empty()) {
               const auto ret = stopAtEndOfRoad();
               return ret;
@@ -0,0 +1,33 @@
+// Copyright 2015-2020 Tier IV, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef BEHAVIOR_TREE_PLUGIN__TEST__HDMAP_UTILS_HPP_
+#define BEHAVIOR_TREE_PLUGIN__TEST__HDMAP_UTILS_HPP_
+
+#include <ament_index_cpp/get_package_share_directory.hpp>
+#include <memory>
+#include <string>
+#include <traffic_simulator/hdmap_utils/hdmap_utils.hpp>
+
+auto makeHdMapUtils() -> std::shared_ptr<hdmap_utils::HdMapUtils>
+{
+  std::string path =
+    ament_index_cpp::get_package_share_directory("traffic_simulator") + "/map/lanelet2_map.osm";
+  geographic_msgs::msg::GeoPoint origin;
+  origin.latitude = 35.61836750154;
+  origin.longitude = 139.78066608243;
+  return std::make_shared<hdmap_utils::HdMapUtils>(path, origin);
+}
+
+#endif  // BEHAVIOR_TREE_PLUGIN__TEST__HDMAP_UTILS_HPP_
@@ -0,0 +1,148 @@
+// Copyright 2015-2020 Tier IV, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <behavior_tree_plugin/pedestrian/behavior_tree.hpp>
+#include <behavior_tree_plugin/pedestrian/crowd.hpp>
+#include <memory>
+#include <string>
+#include <traffic_simulator/helper/helper.hpp>
+#include <vector>
+
+#include "../hdmap_utils.hpp"
+
+constexpr double step_time = 0.05;
+
+constexpr double tolerance = 1e-9;
+
+const std::vector<std::int64_t> route_lanelets = {34606, 34672, 34675};
+
+/**
+ * @brief A pedestrian walking at 1 m/s half a meter before the end of the first route lanelet.
+ */
+auto makeEntityStatus(hdmap_utils::HdMapUtils & hdmap_utils)
+  -> traffic_simulator_msgs::msg::EntityStatus
+{
+  traffic_simulator_msgs::msg::EntityStatus status;
+  status.name = "pedestrian";
+  status.lanelet_pose_valid = true;
+  status.lanelet_pose = traffic_simulator::helper::constructLaneletPose(
+    route_lanelets.front(), hdmap_utils.getLaneletLength(route_lanelets.front()) - 0.5, 0);
+  status.pose = hdmap_utils.toMapPose(status.lanelet_pose).pose;
+  status.action_status.twist.linear.x = 1.0;
+  return status;
+}
+
+void setInputs(
+  entity_behavior::BehaviorPluginBase & plugin,
+  const std::shared_ptr<hdmap_utils::HdMapUtils> & hdmap_utils, const std::string & request)
+{
+  plugin.setHdMapUtils(hdmap_utils);
+  plugin.setTrafficLightManager(nullptr);
+  plugin.setDriverModel(traffic_simulator_msgs::msg::DriverModel());
+  plugin.setPedestrianParameters(traffic_simulator_msgs::msg::PedestrianParameters());
+  plugin.setOtherEntityStatus({});
+  plugin.setLaneletEntityIndex(std::make_shared<const entity_behavior::LaneletEntityIndex>(
+    std::make_shared<const entity_behavior::BehaviorPluginBase::EntityStatusDict>()));
+  plugin.setEntityTypeList({});
+  plugin.setTargetSpeed(boost::none);
+  plugin.setRouteLanelets(route_lanelets);
+  plugin.setRequest(request);
+}
+
+void expectNear(
+  const traffic_simulator_msgs::msg::EntityStatus & actual,
+  const traffic_simulator_msgs::msg::EntityStatus & expected)
+{
+  EXPECT_NEAR(actual.pose.position.x, expected.pose.position.x, tolerance);
+  EXPECT_NEAR(actual.pose.position.y, expected.pose.position.y, tolerance);
+  EXPECT_NEAR(actual.pose.position.z, expected.pose.position.z, tolerance);
+  EXPECT_NEAR(actual.pose.orientation.z, expected.pose.orientation.z, tolerance);
+  EXPECT_NEAR(actual.pose.orientation.w, expected.pose.orientation.w, tolerance);
+  EXPECT_NEAR(
+    actual.action_status.twist.linear.x, expected.action_status.twist.linear.x, tolerance);
+  EXPECT_NEAR(
+    actual.action_status.accel.linear.x, expected.action_status.accel.linear.x, tolerance);
+  EXPECT_EQ(actual.lanelet_pose_valid, expected.lanelet_pose_valid);
+}
+
+/**
+ * @brief Steps a crowd pedestrian and a behavior tree pedestrian side by side and expects the
+ * same status every frame.
+ */
+void expectSameAsBehaviorTree(const std::string & request, bool compare_lanelet_pose)
+{
+  const auto hdmap_utils = makeHdMapUtils();
+  entity_behavior::PedestrianBehaviorTree tree;
+  tree.configure(rclcpp::get_logger("test_crowd"));
+  setInputs(tree, hdmap_utils, request);
+  entity_behavior::PedestrianCrowd crowd;
+  crowd.configure(rclcpp::get_logger("test_crowd"));
+  setInputs(crowd, hdmap_utils, request);
+  auto tree_status = makeEntityStatus(*hdmap_utils);
+  auto crowd_status = tree_status;
+  for (int frame = 0; frame < 40; ++frame) {
+    tree.setEntityStatus(tree_status);
+    tree.update(frame * step_time, step_time);
+    tree_status = tree.getUpdatedStatus();
+    crowd.setEntityStatus(crowd_status);
+    crowd.update(frame * step_time, step_time);
+    crowd_status = crowd.getUpdatedStatus();
+    expectNear(crowd_status, tree_status);
+    if (compare_lanelet_pose) {
+      EXPECT_EQ(crowd_status.lanelet_pose.lanelet_id, tree_status.lanelet_pose.lanelet_id);
+      EXPECT_NEAR(crowd_status.lanelet_pose.s, tree_status.lanelet_pose.s, tolerance);
+    }
+  }
+  if (compare_lanelet_pose) {
+    // the transition to the next route lanelet is covered
+    EXPECT_NE(tree_status.lanelet_pose.lanelet_id, route_lanelets.front());
+  }
+}
+
+TEST(PedestrianCrowd, FollowLane) { expectSameAsBehaviorTree("follow_lane", true); }
+
+// The crowd tries the neighbors of the current lanelet before searching the whole map, so only
+// the pose is compared.
+TEST(PedestrianCrowd, WalkStraight) { expectSameAsBehaviorTree("walk_straight", false); }
+
+TEST(PedestrianCrowd, UpdateBatch)
+{
+  const auto hdmap_utils = makeHdMapUtils();
+  std::vector<std::unique_ptr<entity_behavior::PedestrianCrowd>> crowds;
+  std::vector<entity_behavior::BehaviorPluginBase *> plugins;
+  for (int i = 0; i < 2; ++i) {
+    crowds.push_back(std::make_unique<entity_behavior::PedestrianCrowd>());
+    crowds.back()->configure(rclcpp::get_logger("test_crowd"));
+    setInputs(*crowds.back(), hdmap_utils, "follow_lane");
+    crowds.back()->setEntityStatus(makeEntityStatus(*hdmap_utils));
+    plugins.push_back(crowds.back().get());
+  }
+  entity_behavior::PedestrianCrowd single;
+  single.configure(rclcpp::get_logger("test_crowd"));
+  setInputs(single, hdmap_utils, "follow_lane");
+  single.setEntityStatus(makeEntityStatus(*hdmap_utils));
+  single.update(0, step_time);
+  crowds.front()->updateBatch(plugins, {0, step_time, nullptr, nullptr, nullptr});
+  for (const auto & crowd : crowds) {
+    expectNear(crowd->getUpdatedStatus(), single.getUpdatedStatus());
+  }
+}
+
+int main(int argc, char ** argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,114 @@
+// Copyright 2015-2020 Tier IV, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <behavior_tree_plugin/vehicle/route_context.hpp>
+#include <memory>
+#include <string>
+#include <traffic_simulator/helper/helper.hpp>
+#include <traffic_simulator/math/catmull_rom_spline.hpp>
+#include <vector>
+
+#include "../hdmap_utils.hpp"
+
+constexpr double horizon = 100;
+
+/**
+ * @brief Waypoints the vehicle behavior tree used to measure distances along: the route spline
+ * from the lanelet of the entity, sampled from its s.
+ */
+auto makeWaypoints(
+  hdmap_utils::HdMapUtils & hdmap_utils, const std::vector<std::int64_t> & route_lanelets,
+  const traffic_simulator_msgs::msg::LaneletPose & from) -> std::vector<geometry_msgs::msg::Point>
+{
+  const std::vector<std::int64_t> following_lanelets(
+    std::find(route_lanelets.begin(), route_lanelets.end(), from.lanelet_id),
+    route_lanelets.end());
+  const traffic_simulator::math::CatmullRomSpline spline(
+    hdmap_utils.getCenterPoints(following_lanelets));
+  return spline.getTrajectory(from.s, from.s + horizon, 1.0);
+}
+
+TEST(RouteContext, DistanceToStopLine)
+{
+  const auto hdmap_utils = makeHdMapUtils();
+  // the stop line is in the middle of the last lanelet
+  const std::vector<std::int64_t> route_lanelets = {34606, 34672, 34675};
+  const entity_behavior::RouteContext context(hdmap_utils, route_lanelets);
+  for (const auto lanelet_id : route_lanelets) {
+    for (const auto s : {0.0, 5.0}) {
+      const auto from = traffic_simulator::helper::constructLaneletPose(lanelet_id, s, 0);
+      const auto waypoints = makeWaypoints(*hdmap_utils, route_lanelets, from);
+      const auto expected = hdmap_utils->getDistanceToStopLine(
+        std::vector<std::int64_t>(
+          std::find(route_lanelets.begin(), route_lanelets.end(), lanelet_id),
+          route_lanelets.end()),
+        waypoints);
+      const auto actual = context.getDistanceToStopLine(from, horizon, waypoints);
+      ASSERT_TRUE(expected);
+      ASSERT_TRUE(actual);
+      EXPECT_NEAR(actual.get(), expected.get(), 0.1);
+    }
+  }
+}
+
+TEST(RouteContext, DistanceToTrafficLightStopLine)
+{
+  const auto hdmap_utils = makeHdMapUtils();
+  // the stop line is at the beginning of the last lanelet
+  const std::vector<std::int64_t> route_lanelets = {34438, 34408, 34624};
+  const entity_behavior::RouteContext context(hdmap_utils, route_lanelets);
+  for (const auto lanelet_id : {34438, 34408}) {
+    for (const auto s : {0.0, 5.0}) {
+      const auto from = traffic_simulator::helper::constructLaneletPose(lanelet_id, s, 0);
+      const auto waypoints = makeWaypoints(*hdmap_utils, route_lanelets, from);
+      const auto expected = hdmap_utils->getDistanceToTrafficLightStopLine(
+        std::vector<std::int64_t>(
+          std::find(route_lanelets.begin(), route_lanelets.end(), lanelet_id),
+          route_lanelets.end()),
+        waypoints);
+      const auto actual = context.getDistanceToTrafficLightStopLine(from, horizon, waypoints);
+      ASSERT_TRUE(expected);
+      ASSERT_TRUE(actual);
+      EXPECT_NEAR(actual.get(), expected.get(), 0.1);
+    }
+  }
+}
+
+TEST(RouteContext, DistanceToStopLineDuringLaneChange)
+{
+  const auto hdmap_utils = makeHdMapUtils();
+  const std::vector<std::int64_t> route_lanelets = {34606, 34672, 34675};
+  const entity_behavior::RouteContext context(hdmap_utils, route_lanelets);
+  // while changing lanes, the lanelet pose is still on the lane being left, which is off the route
+  const auto from = traffic_simulator::helper::constructLaneletPose(34513, 5, 0);
+  ASSERT_TRUE(
+    std::find(route_lanelets.begin(), route_lanelets.end(), from.lanelet_id) ==
+    route_lanelets.end());
+  const auto waypoints = makeWaypoints(
+    *hdmap_utils, route_lanelets, traffic_simulator::helper::constructLaneletPose(34606, 5, 0));
+  const auto expected = hdmap_utils->getDistanceToStopLine(route_lanelets, waypoints);
+  const auto actual = context.getDistanceToStopLine(from, horizon, waypoints);
+  ASSERT_TRUE(expected);
+  ASSERT_TRUE(actual);
+  EXPECT_DOUBLE_EQ(actual.get(), expected.get());
+}
+
+int main(int argc, char ** argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
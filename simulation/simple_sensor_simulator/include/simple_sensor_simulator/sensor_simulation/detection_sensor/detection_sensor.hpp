@@ -17,10 +17,15 @@
 
 #include <simulation_api_schema.pb.h>
 
+#include <Eigen/Core>
 #include <autoware_auto_perception_msgs/msg/predicted_objects.hpp>
+#include <cstddef>
 #include <memory>
 #include <rclcpp/rclcpp.hpp>
+#include <simple_sensor_simulator/sensor_simulation/entity_index.hpp>
+#include <simple_sensor_simulator/sensor_simulation/lidar/raycaster.hpp>
 #include <string>
+#include <unordered_set>
 #include <vector>
 
 namespace simple_sensor_simulator
@@ -32,17 +37,83 @@ protected:
 
   simulation_api_schema::DetectionSensorConfiguration configuration_;
 
+  CullStatistics cull_statistics_;
+
   explicit DetectionSensorBase(
     const double last_update_stamp,
     const simulation_api_schema::DetectionSensorConfiguration & configuration)
-  : last_update_stamp_(last_update_stamp), configuration_(configuration)
+  : last_update_stamp_(last_update_stamp + configuration.phase_offset()),
+    configuration_(configuration)
   {
   }
 
+  /**
+   * @brief Whether a bounding sphere at the given position in the sensor frame overlaps the
+   * horizontal field of view.
+   */
+  auto isInFieldOfView(const Eigen::Vector3d & position, double bounding_radius) const -> bool;
+
+  /**
+   * @brief Indices of the entities within the range and the field of view of the sensor, in the
+   * order of status.
+   */
+  auto getEntitiesInView(
+    const std::vector<traffic_simulator_msgs::EntityStatus> &, const EntityIndex &)
+    -> std::vector<std::size_t>;
+
+  /**
+   * @brief Names of the given entities that are not fully occluded as seen from the center of the
+   * bounding box of the sensor entity.
+   * @note Each entity gets at most occlusion_ray_budget rays, and no more rays once one of them
+   * reaches it. The bounding box of the sensor entity itself occludes nothing.
+   */
+  auto getVisibleEntities(
+    const std::vector<traffic_simulator_msgs::EntityStatus> &, const EntityIndex &,
+    const std::vector<std::size_t> & entities, const Raycaster & occlusion_raycaster) const
+    -> std::unordered_set<std::string>;
+
 public:
+  /**
+   * @brief Add the bounding box of every entity to the raycaster the sensors in the occlusion mode
+   * query, and commit its scene.
+   * @note The scene is built once per frame and shared by all those sensors.
+   */
+  static auto updateOcclusionScene(
+    Raycaster & occlusion_raycaster, const std::vector<traffic_simulator_msgs::EntityStatus> &,
+    const EntityIndex &) -> void;
+
+  /**
+   * @brief Whether the sensor tests occlusion by raycasting, i.e. occlusion_ray_budget is not 0.
+   * @note Otherwise it reports the entities hit by the lidar sensors.
+   */
+  auto isOcclusionMode() const -> bool { return configuration_.occlusion_ray_budget() > 0; }
+
+  /**
+   * @brief Whether an update is due at current_time. If so, the next update is due one update
+   * duration later.
+   */
+  auto trigger(const double current_time) -> bool
+  {
+    if (current_time - last_update_stamp_ - configuration_.update_duration() >= -0.002) {
+      last_update_stamp_ = current_time;
+      return true;
+    } else {
+      return false;
+    }
+  }
+
+  /**
+   * @note occlusion_raycaster is only used in the occlusion mode, and must have been updated by
+   * updateOcclusionScene for the same status.
+   */
   virtual void update(
-    const double, const std::vector<traffic_simulator_msgs::EntityStatus> &, const rclcpp::Time &,
-    const std::vector<std::string> &) = 0;
+    const std::vector<traffic_simulator_msgs::EntityStatus> &, const EntityIndex &,
+    const rclcpp::Time &, const std::vector<std::string> &,
+    const Raycaster * occlusion_raycaster) = 0;
+
+  auto getCullStatistics() const -> const CullStatistics & { return cull_statistics_; }
+
+  auto getEntityName() const -> const std::string & { return configuration_.entity(); }
 };
 
 template <typename T>
@@ -60,14 +131,14 @@ public:
   }
 
   auto update(
-    const double, const std::vector<traffic_simulator_msgs::EntityStatus> &, const rclcpp::Time &,
-    const std::vector<std::string> &) -> void override;
+    const std::vector<traffic_simulator_msgs::EntityStatus> &, const EntityIndex &,
+    const rclcpp::Time &, const std::vector<std::string> &, const Raycaster *) -> void override;
 };
 
 template <>
 void DetectionSensor<autoware_auto_perception_msgs::msg::PredictedObjects>::update(
-  const double, const std::vector<traffic_simulator_msgs::EntityStatus> &, const rclcpp::Time &,
-  const std::vector<std::string> &);
+  const std::vector<traffic_simulator_msgs::EntityStatus> &, const EntityIndex &,
+  const rclcpp::Time &, const std::vector<std::string> &, const Raycaster *);
 }  // namespace simple_sensor_simulator
 
 #endif  // SIMPLE_SENSOR_SIMULATOR__SENSOR_SIMULATION__DETECTION_SENSOR__DETECTION_SENSOR_HPP_
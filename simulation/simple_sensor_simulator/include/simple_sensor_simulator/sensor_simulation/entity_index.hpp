@@ -0,0 +1,84 @@
+// Copyright 2015-2020 Tier IV, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef SIMPLE_SENSOR_SIMULATOR__SENSOR_SIMULATION__ENTITY_INDEX_HPP_
+#define SIMPLE_SENSOR_SIMULATOR__SENSOR_SIMULATION__ENTITY_INDEX_HPP_
+
+#include <simulation_api_schema.pb.h>
+
+#include <Eigen/Core>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace simple_sensor_simulator
+{
+/**
+ * @brief Number of entities a sensor skipped before doing any geometry work for them, summed over
+ * all of its updates.
+ */
+struct CullStatistics
+{
+  std::size_t entities = 0;
+
+  std::size_t culled_by_range = 0;
+
+  std::size_t culled_by_fov = 0;
+};
+
+/**
+ * @brief Uniform grid over the bounding spheres of the entities of one frame, shared by all the
+ * sensors updated in that frame.
+ */
+class EntityIndex
+{
+public:
+  explicit EntityIndex(
+    const std::vector<traffic_simulator_msgs::EntityStatus> & status, double cell_size = 50);
+
+  /**
+   * @brief Indices of the entities whose bounding sphere overlaps the vertical cylinder of the
+   * given radius around center, in ascending order.
+   */
+  auto query(const Eigen::Vector3d & center, double radius) const -> std::vector<std::size_t>;
+
+  auto size() const -> std::size_t { return centers_.size(); }
+
+  /**
+   * @brief Center of the bounding box of the entity in the map frame.
+   */
+  auto getCenter(std::size_t index) const -> const Eigen::Vector3d & { return centers_[index]; }
+
+  auto getBoundingRadius(std::size_t index) const -> double { return bounding_radii_[index]; }
+
+private:
+  auto getCellIndex(double value) const -> std::int64_t;
+
+  static auto getCellKey(std::int64_t column, std::int64_t row) -> std::int64_t;
+
+  const double cell_size_;
+
+  double max_bounding_radius_ = 0;
+
+  std::vector<Eigen::Vector3d> centers_;
+
+  std::vector<double> bounding_radii_;
+
+  std::unordered_map<std::int64_t, std::vector<std::size_t>> cells_;
+};
+}  // namespace simple_sensor_simulator
+
+#endif  // SIMPLE_SENSOR_SIMULATOR__SENSOR_SIMULATION__ENTITY_INDEX_HPP_
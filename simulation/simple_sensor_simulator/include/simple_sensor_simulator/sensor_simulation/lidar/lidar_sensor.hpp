@@ -17,9 +17,15 @@
 
 #include <simulation_api_schema.pb.h>
 
+#include <Eigen/Core>
+#include <algorithm>
+#include <limits>
 #include <memory>
 #include <rclcpp/rclcpp.hpp>
 #include <sensor_msgs/msg/point_cloud2.hpp>
+#include <simple_sensor_simulator/sensor_simulation/entity_index.hpp>
+#include <simple_sensor_simulator/sensor_simulation/lidar/raycaster.hpp>
+#include <simple_sensor_simulator/sensor_simulation/thread_pool.hpp>
 #include <string>
 #include <vector>
 
@@ -34,18 +40,59 @@ protected:
 
   std::vector<std::string> detected_objects_;
 
+  CullStatistics cull_statistics_;
+
+  double min_elevation_ = std::numeric_limits<double>::infinity();
+
+  double max_elevation_ = -std::numeric_limits<double>::infinity();
+
   explicit LidarSensorBase(
     const double last_update_stamp, const simulation_api_schema::LidarConfiguration & configuration)
-  : last_update_stamp_(last_update_stamp), configuration_(configuration)
+  : last_update_stamp_(last_update_stamp + configuration.phase_offset()),
+    configuration_(configuration)
+  {
+    // A vertical angle is the pitch of the rays, so positive angles point downwards.
+    for (const auto vertical_angle : configuration_.vertical_angles()) {
+      min_elevation_ = std::min(min_elevation_, -vertical_angle);
+      max_elevation_ = std::max(max_elevation_, -vertical_angle);
+    }
+  }
+
+  auto getRange() const -> double
   {
+    return configuration_.range() > 0 ? configuration_.range() : 100;
   }
 
+  /**
+   * @brief Whether a bounding sphere at the given position in the sensor frame may be hit by a ray
+   * of the lidar, judging from the vertical angles only.
+   */
+  auto isInFieldOfView(const Eigen::Vector3d & position, double bounding_radius) const -> bool;
+
 public:
+  /**
+   * @brief Whether a scan is due at current_time. If so, the next scan is due one scan duration
+   * later.
+   */
+  auto trigger(const double current_time) -> bool
+  {
+    if (current_time - last_update_stamp_ - configuration_.scan_duration() >= -0.002) {
+      last_update_stamp_ = current_time;
+      return true;
+    } else {
+      return false;
+    }
+  }
+
   virtual auto update(
-    const double, const std::vector<traffic_simulator_msgs::EntityStatus> &, const rclcpp::Time &)
-    -> void = 0;
+    const std::vector<traffic_simulator_msgs::EntityStatus> &, const EntityIndex &,
+    const rclcpp::Time &) -> void = 0;
 
   auto getDetectedObjects() const -> const std::vector<std::string> & { return detected_objects_; }
+
+  auto getCullStatistics() const -> const CullStatistics & { return cull_statistics_; }
+
+  auto getEntityName() const -> const std::string & { return configuration_.entity(); }
 };
 
 template <typename T>
@@ -53,34 +100,46 @@ class LidarSensor : public LidarSensorBase
 {
   const typename rclcpp::Publisher<T>::SharedPtr publisher_ptr_;
 
-  auto raycast(const std::vector<traffic_simulator_msgs::EntityStatus> &, const rclcpp::Time &)
-    -> T;
+  Raycaster raycaster_;
+
+  // Reused across scans so that its point buffer is allocated only once.
+  T message_;
+
+  auto raycast(
+    const std::vector<traffic_simulator_msgs::EntityStatus> &, const EntityIndex &,
+    const rclcpp::Time &, T &) -> void;
 
 public:
   explicit LidarSensor(
     const double current_time, const simulation_api_schema::LidarConfiguration & configuration,
-    const typename rclcpp::Publisher<T>::SharedPtr & publisher_ptr)
-  : LidarSensorBase(current_time, configuration), publisher_ptr_(publisher_ptr)
+    const typename rclcpp::Publisher<T>::SharedPtr & publisher_ptr,
+    ThreadPool * thread_pool = nullptr,
+    const std::shared_ptr<const RaycastDevice> & device = nullptr)
+  : LidarSensorBase(current_time, configuration),
+    publisher_ptr_(publisher_ptr),
+    raycaster_(device ? device : std::make_shared<const RaycastDevice>())
   {
+    raycaster_.setThreadPool(thread_pool);
+    // Rays start above the road surface of the map, not from base_link on it.
+    raycaster_.setSensorPosition(Eigen::Vector3f(0, 0, configuration_.mounting_height()));
+    raycaster_.setDirections(
+      configuration_.horizontal_resolution(),
+      {configuration_.vertical_angles().begin(), configuration_.vertical_angles().end()});
   }
 
   auto update(
-    const double current_time, const std::vector<traffic_simulator_msgs::EntityStatus> & status,
-    const rclcpp::Time & stamp) -> void override
+    const std::vector<traffic_simulator_msgs::EntityStatus> & status,
+    const EntityIndex & entity_index, const rclcpp::Time & stamp) -> void override
   {
-    if (current_time - last_update_stamp_ - configuration_.scan_duration() >= -0.002) {
-      last_update_stamp_ = current_time;
-      publisher_ptr_->publish(raycast(status, stamp));
-    } else {
-      detected_objects_ = {};
-    }
+    raycast(status, entity_index, stamp, message_);
+    publisher_ptr_->publish(message_);
   }
 };
 
 template <>
 auto LidarSensor<sensor_msgs::msg::PointCloud2>::raycast(
-  const std::vector<traffic_simulator_msgs::EntityStatus> &, const rclcpp::Time &)
-  -> sensor_msgs::msg::PointCloud2;
+  const std::vector<traffic_simulator_msgs::EntityStatus> &, const EntityIndex &,
+  const rclcpp::Time &, sensor_msgs::msg::PointCloud2 &) -> void;
 }  // namespace simple_sensor_simulator
 
 #endif  // SIMPLE_SENSOR_SIMULATOR__SENSOR_SIMULATION__LIDAR__LIDAR_SENSOR_HPP_
@@ -15,9 +15,11 @@
 #ifndef SIMPLE_SENSOR_SIMULATOR__SENSOR_SIMULATION__LIDAR__RAYCASTER_HPP_
 #define SIMPLE_SENSOR_SIMULATOR__SENSOR_SIMULATION__LIDAR__RAYCASTER_HPP_
 
+#include <Eigen/Core>
 #include <embree3/rtcore.h>
 #include <pcl_conversions/pcl_conversions.h>
 
+#include <array>
 #include <geometry_msgs/msg/pose.hpp>
 #include <geometry_msgs/msg/vector3.hpp>
 #include <memory>
@@ -25,6 +27,7 @@
 #include <sensor_msgs/msg/point_cloud2.hpp>
 #include <simple_sensor_simulator/sensor_simulation/primitives/box.hpp>
 #include <simple_sensor_simulator/sensor_simulation/primitives/primitive.hpp>
+#include <simple_sensor_simulator/sensor_simulation/thread_pool.hpp>
 #include <string>
 #include <unordered_map>
 #include <utility>
@@ -32,38 +35,173 @@
 
 namespace simple_sensor_simulator
 {
+/**
+ * @brief Embree device shared by raycasters, with the scene of the static geometry built once on
+ * it.
+ * @note A scene can only be instanced in scenes of the same device, so the raycasters that trace
+ * against the static geometry are created on this device.
+ */
+class RaycastDevice
+{
+public:
+  RaycastDevice();
+  explicit RaycastDevice(const std::string & embree_config);
+  ~RaycastDevice();
+  RaycastDevice(const RaycastDevice &) = delete;
+  RaycastDevice & operator=(const RaycastDevice &) = delete;
+  /**
+   * @brief Build the scene of a primitive that never moves, such as the lanelet map.
+   * @note Raycasters created on this device afterwards instance the scene, so its size adds no
+   * build cost to each of them.
+   */
+  void setStaticPrimitive(const primitives::Primitive & primitive);
+  RTCDevice get() const { return device_; }
+  RTCScene getStaticScene() const { return static_scene_; }
+  const std::array<float, 12> & getStaticTransform() const { return static_transform_; }
+
+private:
+  RTCDevice device_;
+  RTCScene static_scene_ = nullptr;
+  std::array<float, 12> static_transform_ = {};
+};
+
+/**
+ * @brief Lidar raycaster that keeps its Embree device and scene across frames.
+ * @note Each primitive is an instance of a scene of its own shape. Re-adding a primitive of the
+ * same name and shape only moves its instance, so that raycast rebuilds the top level BVH over
+ * the instances and never the meshes. Primitives not added again since the previous raycast are
+ * removed from the scene.
+ */
 class Raycaster
 {
 public:
   Raycaster();
   explicit Raycaster(std::string embree_config);
+  /**
+   * @brief Raycaster on a shared device, tracing the rays also against its static geometry.
+   * @note Hits of the static geometry yield points but no detected objects.
+   */
+  explicit Raycaster(const std::shared_ptr<const RaycastDevice> & device);
   ~Raycaster();
+  Raycaster(const Raycaster &) = delete;
+  Raycaster & operator=(const Raycaster &) = delete;
   template <typename T, typename... Ts>
   void addPrimitive(std::string name, Ts &&... xs)
   {
-    if (primitive_ptrs_.count(name) != 0) {
+    auto primitive_ptr = std::make_unique<T>(std::forward<Ts>(xs)...);
+    auto iter = instances_.find(name);
+    if (iter == instances_.end()) {
+      iter = instances_.emplace(name, Instance()).first;
+    } else if (iter->second.added) {
       throw std::runtime_error("primitive " + name + " already exist.");
     }
-    auto primitive_ptr = std::make_unique<T>(std::forward<Ts>(xs)...);
-    primitive_ptrs_.emplace(name, std::move(primitive_ptr));
+    updateInstance(iter->first, iter->second, std::move(primitive_ptr));
   }
+  /**
+   * @brief Compile the scan pattern of a lidar into the ray direction table used by raycast.
+   * @note The table is in the sensor frame, so it only has to be rebuilt when the configuration
+   * of the lidar changes.
+   */
+  void setDirections(
+    double horizontal_resolution, const std::vector<double> & vertical_angles,
+    double horizontal_angle_start = 0, double horizontal_angle_end = 2 * M_PI);
+  const sensor_msgs::msg::PointCloud2 raycast(
+    std::string frame_id, const rclcpp::Time & stamp, geometry_msgs::msg::Pose origin,
+    double max_distance = 100, double min_distance = 0);
+  /**
+   * @brief Write the hits straight into pointcloud_msg.
+   * @note The buffer of pointcloud_msg is reused, so passing the same message every scan avoids
+   * reallocating it.
+   */
+  void raycast(
+    const std::string & frame_id, const rclcpp::Time & stamp,
+    const geometry_msgs::msg::Pose & origin, sensor_msgs::msg::PointCloud2 & pointcloud_msg,
+    double max_distance = 100, double min_distance = 0);
   const sensor_msgs::msg::PointCloud2 raycast(
     std::string frame_id, const rclcpp::Time & stamp, geometry_msgs::msg::Pose origin,
     double horizontal_resolution, std::vector<double> vertical_angles,
     double horizontal_angle_start = 0, double horizontal_angle_end = 2 * M_PI,
     double max_distance = 100, double min_distance = 0);
   const std::vector<std::string> & getDetectedObject() const;
+  /**
+   * @brief Build the scene traced by getVisiblePrimitives from the primitives added since the
+   * previous commit.
+   * @note Primitives not added again since the previous commit are removed from the scene, as in
+   * raycast.
+   */
+  void commitScene();
+  /**
+   * @brief Names of the given primitives at least one of whose sample points is seen from origin
+   * without anything but the excluded primitive in between.
+   * @note Casts at most ray_budget rays per primitive and stops at the first one that reaches it.
+   * Only reads the scene of the last commitScene, so several threads may query it at once.
+   */
+  std::vector<std::string> getVisiblePrimitives(
+    const geometry_msgs::msg::Point & origin, const std::vector<std::string> & names,
+    size_t ray_budget, const std::string & excluded = "") const;
+  /**
+   * @brief Width of the ray packets traced by raycast, or 1 if rays are traced one by one.
+   * @note Selected from the widest packet the CPU supports natively when the device is created.
+   */
+  size_t getRayPacketSize() const { return ray_packet_size_; }
+  /**
+   * @brief Override the width of the ray packets selected from the CPU with 1, 4, 8 or 16.
+   * @note Embree emulates widths the CPU does not support natively, so every width returns the
+   * same hits.
+   */
+  void setRayPacketSize(size_t ray_packet_size);
+  /**
+   * @brief Position of the sensor in the frame of the origin given to raycast.
+   * @note Rays start from this position, while points are still expressed in the frame of origin.
+   */
+  void setSensorPosition(const Eigen::Vector3f & sensor_position)
+  {
+    sensor_position_ = sensor_position;
+  }
+  /**
+   * @brief Split the rays of each raycast into angular sectors traced in parallel on the pool.
+   * @note Rays are traced on the calling thread only if no thread pool is set.
+   */
+  void setThreadPool(ThreadPool * thread_pool) { thread_pool_ = thread_pool; }
 
 private:
-  std::unordered_map<std::string, std::unique_ptr<primitives::Primitive>> primitive_ptrs_;
-  RTCDevice device_;
+  struct Hit
+  {
+    unsigned int geometry_id;
+    unsigned int instance_id;
+    float distance;
+  };
+  static auto selectRayPacketSize(RTCDevice device) -> size_t;
+  auto intersect(
+    const geometry_msgs::msg::Point & origin, const Eigen::Matrix3Xf & directions,
+    double max_distance, double min_distance) -> std::vector<Hit>;
+  void intersect(
+    const geometry_msgs::msg::Point & origin, const Eigen::Matrix3Xf & directions,
+    double max_distance, double min_distance, size_t first, size_t last,
+    std::vector<Hit> & hits) const;
+  struct Instance
+  {
+    std::unique_ptr<primitives::Primitive> primitive_ptr;
+    RTCScene local_scene = nullptr;
+    RTCGeometry geometry = nullptr;
+    unsigned int geometry_id = RTC_INVALID_GEOMETRY_ID;
+    bool added = false;
+  };
+  void updateInstance(
+    const std::string & name, Instance & instance,
+    std::unique_ptr<primitives::Primitive> primitive_ptr);
+  void releaseInstance(Instance & instance);
+  std::unordered_map<std::string, Instance> instances_;
+  Instance static_instance_;
+  const std::shared_ptr<const RaycastDevice> device_;
+  size_t ray_packet_size_;
+  ThreadPool * thread_pool_ = nullptr;
   RTCScene scene_;
   std::random_device seed_gen_;
   std::default_random_engine engine_;
-  const sensor_msgs::msg::PointCloud2 raycast(
-    std::string frame_id, const rclcpp::Time & stamp, geometry_msgs::msg::Pose origin,
-    std::vector<geometry_msgs::msg::Quaternion> directions, double max_distance = 100,
-    double min_distance = 0);
+  // Unit ray directions in the sensor frame, one column per ray.
+  Eigen::Matrix3Xf direction_table_;
+  Eigen::Vector3f sensor_position_ = Eigen::Vector3f::Zero();
   std::vector<std::string> detected_objects_;
   std::unordered_map<unsigned int, std::string> geometry_ids_;
 };
@@ -0,0 +1,47 @@
+// Copyright 2015-2020 Tier IV, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef SIMPLE_SENSOR_SIMULATOR__SENSOR_SIMULATION__PRIMITIVES__LANELET_MAP_HPP_
+#define SIMPLE_SENSOR_SIMULATOR__SENSOR_SIMULATION__PRIMITIVES__LANELET_MAP_HPP_
+
+#include <lanelet2_core/LaneletMap.h>
+
+#include <simple_sensor_simulator/sensor_simulation/primitives/primitive.hpp>
+#include <string>
+#include <vector>
+
+namespace simple_sensor_simulator
+{
+namespace primitives
+{
+/**
+ * @brief Static geometry of a lanelet map in the map frame.
+ * @note Contains the road surface of every lanelet, a vertical wall along every line string of a
+ * curb, road border, fence or wall type, and the side walls of every polygon with a height
+ * attribute. A "height" attribute of a line string overrides the default height of its type.
+ */
+class LaneletMap : public Primitive
+{
+public:
+  explicit LaneletMap(const std::string & lanelet2_map_path);
+  ~LaneletMap() = default;
+
+private:
+  void addRoadSurface(const lanelet::ConstLanelet & lanelet);
+  void addWall(const std::vector<Vertex> & outline, double height);
+};
+}  // namespace primitives
+}  // namespace simple_sensor_simulator
+
+#endif  // SIMPLE_SENSOR_SIMULATOR__SENSOR_SIMULATION__PRIMITIVES__LANELET_MAP_HPP_
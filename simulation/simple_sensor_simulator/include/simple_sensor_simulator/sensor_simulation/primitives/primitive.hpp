@@ -18,6 +18,7 @@
 #include <embree3/rtcore.h>
 
 #include <algorithm>
+#include <array>
 #include <geometry_msgs/msg/pose.hpp>
 #include <string>
 #include <vector>
@@ -48,8 +49,25 @@ public:
   const std::string type;
   const geometry_msgs::msg::Pose pose;
   unsigned int addToScene(RTCDevice device, RTCScene scene);
+  /**
+   * @brief Creates a committed scene of the primitive in its own frame, to be instanced at pose.
+   */
+  RTCScene createLocalScene(RTCDevice device) const;
+  bool hasSameShape(const Primitive & other) const;
+  /**
+   * @brief Transform from the frame of the primitive to the map frame, in the column major 3x4
+   * layout of RTC_FORMAT_FLOAT3X4_COLUMN_MAJOR.
+   */
+  std::array<float, 12> getTransform() const;
   std::vector<Vertex> getVertex() const;
   std::vector<Triangle> getTriangles() const;
+  /**
+   * @brief Up to max_count points inside the primitive in the map frame, to aim visibility rays at.
+   * @note The origin of the primitive comes first, followed by its vertices pulled slightly toward
+   * the origin, alternating between the two ends of the vertex list so that the first few points
+   * are spread over the shape.
+   */
+  std::vector<Vertex> getSamplePoints(size_t max_count) const;
 
 protected:
   std::vector<Vertex> transform() const;
@@ -58,6 +76,7 @@ protected:
 
 private:
   Vertex transform(Vertex v) const;
+  RTCGeometry createMesh(RTCDevice device, const std::vector<Vertex> & vertices) const;
 };
 }  // namespace primitives
 }  // namespace simple_sensor_simulator
@@ -17,27 +17,70 @@
 
 #include <simulation_api_schema.pb.h>
 
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
 #include <iomanip>
 #include <memory>
+#include <mutex>
 #include <rclcpp/rclcpp.hpp>
 #include <simple_sensor_simulator/sensor_simulation/detection_sensor/detection_sensor.hpp>
+#include <simple_sensor_simulator/sensor_simulation/entity_index.hpp>
 #include <simple_sensor_simulator/sensor_simulation/lidar/lidar_sensor.hpp>
+#include <simple_sensor_simulator/sensor_simulation/primitives/lanelet_map.hpp>
+#include <simple_sensor_simulator/sensor_simulation/thread_pool.hpp>
+#include <string>
+#include <thread>
 #include <vector>
 
 namespace simple_sensor_simulator
 {
+/**
+ * @brief Schedules the sensors and generates their outputs in the background.
+ * @note updateSensorFrame only decides which sensors are due and queues a snapshot of the entity
+ * status for them. The outputs are generated and published on a background thread, in the order
+ * of the frames and stamped with the simulation time of the frame they were triggered at.
+ */
 class SensorSimulation
 {
 public:
+  /**
+   * @param worker_threads Number of threads the lidar and detection sensors are simulated on. 0
+   * means the number of hardware threads.
+   */
+  explicit SensorSimulation(std::size_t worker_threads = 0);
+
+  ~SensorSimulation();
+
+  /**
+   * @brief Load the static geometry the sensors attached afterwards trace against.
+   * @note The geometry is built once on a raycast device shared by those sensors. An empty path
+   * unloads it.
+   */
+  auto loadLaneletMap(const std::string & lanelet2_map_path) -> void
+  {
+    auto device = std::make_shared<RaycastDevice>();
+    if (!lanelet2_map_path.empty()) {
+      device->setStaticPrimitive(primitives::LaneletMap(lanelet2_map_path));
+    }
+    raycast_device_ = std::move(device);
+    if (occlusion_raycaster_) {
+      occlusion_raycaster_ = std::make_unique<Raycaster>(raycast_device_);
+    }
+  }
+
   auto attachLidarSensor(
     const double current_simulation_time,
     const simulation_api_schema::LidarConfiguration & configuration, rclcpp::Node & node) -> void
   {
+    waitForPendingFrames();
     if (configuration.architecture_type() == "awf/universe") {
       lidar_sensors_.push_back(std::make_unique<LidarSensor<sensor_msgs::msg::PointCloud2>>(
         current_simulation_time, configuration,
         node.create_publisher<sensor_msgs::msg::PointCloud2>(
-          "/perception/obstacle_segmentation/pointcloud", 1)));
+          "/perception/obstacle_segmentation/pointcloud", 1),
+        &thread_pool_, raycast_device_));
     } else {
       std::stringstream ss;
       ss << "Unexpected architecture_type " << std::quoted(configuration.architecture_type())
@@ -51,11 +94,15 @@ public:
     const simulation_api_schema::DetectionSensorConfiguration & configuration, rclcpp::Node & node)
     -> void
   {
+    waitForPendingFrames();
     if (configuration.architecture_type() == "awf/universe") {
       using Message = autoware_auto_perception_msgs::msg::PredictedObjects;
       detection_sensors_.push_back(std::make_unique<DetectionSensor<Message>>(
         current_simulation_time, configuration,
         node.create_publisher<Message>("/perception/object_recognition/objects", 1)));
+      if (detection_sensors_.back()->isOcclusionMode() && !occlusion_raycaster_) {
+        occlusion_raycaster_ = std::make_unique<Raycaster>(raycast_device_);
+      }
     } else {
       std::stringstream ss;
       ss << "Unexpected architecture_type " << std::quoted(configuration.architecture_type())
@@ -64,13 +111,55 @@ public:
     }
   }
 
+  /**
+   * @note Blocks only while max_pending_frames frames are still being generated. An exception
+   * thrown while generating a previous frame is rethrown here.
+   */
   void updateSensorFrame(
     double current_time, const rclcpp::Time & current_ros_time,
     const std::vector<traffic_simulator_msgs::EntityStatus> & status);
 
+  /**
+   * @brief Wait until the outputs of all the frames queued so far have been published.
+   */
+  auto waitForPendingFrames() -> void;
+
+  /**
+   * @brief Log how many entities each sensor culled by range and by field of view so far.
+   */
+  auto logCullStatistics(const rclcpp::Logger & logger) -> void;
+
+  static constexpr std::size_t max_pending_frames = 2;
+
 private:
+  struct Frame
+  {
+    rclcpp::Time stamp;
+    std::vector<traffic_simulator_msgs::EntityStatus> status;
+    std::vector<bool> lidar_triggers;
+    std::vector<bool> detection_triggers;
+  };
+
+  auto updateSensors(const Frame & frame) -> void;
+
+  auto processFrames() -> void;
+
+  ThreadPool thread_pool_;
+  // Shared by all the sensors attached since the last loadLaneletMap.
+  std::shared_ptr<const RaycastDevice> raycast_device_ = std::make_shared<RaycastDevice>();
   std::vector<std::unique_ptr<LidarSensorBase>> lidar_sensors_;
   std::vector<std::unique_ptr<DetectionSensorBase>> detection_sensors_;
+  // One scene of all the entities per frame, queried by every detection sensor in the occlusion
+  // mode.
+  std::unique_ptr<Raycaster> occlusion_raycaster_;
+
+  std::mutex mutex_;
+  std::condition_variable condition_;
+  // The front frame is the one being generated, so it is popped only once it has been published.
+  std::deque<Frame> frames_;
+  std::exception_ptr exception_ = nullptr;
+  bool stop_ = false;
+  std::thread output_thread_;
 };
 }  // namespace simple_sensor_simulator
 
@@ -0,0 +1,65 @@
+// Copyright 2015-2020 Tier IV, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef SIMPLE_SENSOR_SIMULATOR__SENSOR_SIMULATION__THREAD_POOL_HPP_
+#define SIMPLE_SENSOR_SIMULATOR__SENSOR_SIMULATION__THREAD_POOL_HPP_
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace simple_sensor_simulator
+{
+/**
+ * @brief Fixed size pool of worker threads shared by the sensors.
+ * @note The thread calling parallelFor runs queued tasks while it waits, so parallelFor may be
+ * called from inside a task (e.g. a lidar sensor splitting its scan while the sensors themselves
+ * run in parallel) without deadlocking the pool.
+ */
+class ThreadPool
+{
+public:
+  /**
+   * @param threads Number of threads including the calling thread. 0 means the number of
+   * hardware threads, and 1 runs everything on the calling thread.
+   */
+  explicit ThreadPool(std::size_t threads = 0);
+  ~ThreadPool();
+  ThreadPool(const ThreadPool &) = delete;
+  ThreadPool & operator=(const ThreadPool &) = delete;
+
+  auto size() const -> std::size_t { return workers_.size() + 1; }
+
+  /**
+   * @brief Call function(0), ..., function(n - 1) in parallel and wait for all of them.
+   * @note The first exception thrown by any of the calls is rethrown after all calls finished.
+   */
+  auto parallelFor(std::size_t n, const std::function<void(std::size_t)> & function) -> void;
+
+private:
+  auto work() -> void;
+
+  std::mutex mutex_;
+  std::condition_variable condition_;
+  std::deque<std::function<void()>> tasks_;
+  bool stop_ = false;
+  std::vector<std::thread> workers_;
+};
+}  // namespace simple_sensor_simulator
+
+#endif  // SIMPLE_SENSOR_SIMULATOR__SENSOR_SIMULATION__THREAD_POOL_HPP_
@@ -12,23 +12,124 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <quaternion_operation/quaternion_operation.h>
+
 #include <algorithm>
 #include <boost/uuid/uuid.hpp>
 #include <boost/uuid/uuid_generators.hpp>
 #include <boost/uuid/uuid_io.hpp>
+#include <cmath>
+#include <iterator>
 #include <memory>
+#include <numeric>
 #include <simple_sensor_simulator/exception.hpp>
 #include <simple_sensor_simulator/sensor_simulation/detection_sensor/detection_sensor.hpp>
+#include <simple_sensor_simulator/sensor_simulation/primitives/box.hpp>
 #include <simulation_interface/conversions.hpp>
 #include <string>
+#include <unordered_set>
 #include <vector>
 
 namespace simple_sensor_simulator
 {
+auto DetectionSensorBase::isInFieldOfView(
+  const Eigen::Vector3d & position, double bounding_radius) const -> bool
+{
+  const auto distance = position.head<2>().norm();
+  if (
+    configuration_.horizontal_fov() <= 0 || configuration_.horizontal_fov() >= 2 * M_PI ||
+    distance <= bounding_radius) {
+    return true;
+  }
+  const auto azimuth = std::abs(std::atan2(position.y(), position.x()));
+  return azimuth - std::asin(bounding_radius / distance) <= 0.5 * configuration_.horizontal_fov();
+}
+
+auto DetectionSensorBase::getEntitiesInView(
+  const std::vector<traffic_simulator_msgs::EntityStatus> & status,
+  const EntityIndex & entity_index) -> std::vector<std::size_t>
+{
+  std::vector<std::size_t> entities(status.size());
+  std::iota(entities.begin(), entities.end(), 0);
+  const auto ego = std::find_if(status.begin(), status.end(), [this](const auto & s) {
+    return s.name() == configuration_.entity();
+  });
+  if (ego == status.end()) {
+    return entities;
+  }
+  geometry_msgs::msg::Pose pose;
+  simulation_interface::toMsg(ego->pose(), pose);
+  const Eigen::Vector3d origin(pose.position.x, pose.position.y, pose.position.z);
+  const auto rotation = quaternion_operation::getRotationMatrix(pose.orientation);
+  if (configuration_.range() > 0) {
+    entities = entity_index.query(origin, configuration_.range());
+  }
+  cull_statistics_.entities += status.size() - 1;
+  cull_statistics_.culled_by_range += status.size() - entities.size();
+  const auto ego_index = static_cast<std::size_t>(std::distance(status.begin(), ego));
+  std::vector<std::size_t> ret;
+  for (const auto i : entities) {
+    const Eigen::Vector3d position = rotation.transpose() * (entity_index.getCenter(i) - origin);
+    if (i == ego_index || isInFieldOfView(position, entity_index.getBoundingRadius(i))) {
+      ret.emplace_back(i);
+    } else {
+      cull_statistics_.culled_by_fov++;
+    }
+  }
+  return ret;
+}
+
+auto DetectionSensorBase::updateOcclusionScene(
+  Raycaster & occlusion_raycaster, const std::vector<traffic_simulator_msgs::EntityStatus> & status,
+  const EntityIndex & entity_index) -> void
+{
+  for (std::size_t i = 0; i < status.size(); i++) {
+    const auto & s = status[i];
+    const auto & center = entity_index.getCenter(i);
+    geometry_msgs::msg::Pose pose;
+    simulation_interface::toMsg(s.pose(), pose);
+    pose.position.x = center.x();
+    pose.position.y = center.y();
+    pose.position.z = center.z();
+    occlusion_raycaster.addPrimitive<primitives::Box>(
+      s.name(), s.bounding_box().dimensions().x(), s.bounding_box().dimensions().y(),
+      s.bounding_box().dimensions().z(), pose);
+  }
+  occlusion_raycaster.commitScene();
+}
+
+auto DetectionSensorBase::getVisibleEntities(
+  const std::vector<traffic_simulator_msgs::EntityStatus> & status,
+  const EntityIndex & entity_index, const std::vector<std::size_t> & entities,
+  const Raycaster & occlusion_raycaster) const -> std::unordered_set<std::string>
+{
+  const auto ego = std::find_if(status.begin(), status.end(), [this](const auto & s) {
+    return s.name() == configuration_.entity();
+  });
+  if (ego == status.end()) {
+    return {};
+  }
+  const auto ego_index = static_cast<std::size_t>(std::distance(status.begin(), ego));
+  std::vector<std::string> names;
+  for (const auto i : entities) {
+    if (i != ego_index) {
+      names.emplace_back(status[i].name());
+    }
+  }
+  geometry_msgs::msg::Point origin;
+  origin.x = entity_index.getCenter(ego_index).x();
+  origin.y = entity_index.getCenter(ego_index).y();
+  origin.z = entity_index.getCenter(ego_index).z();
+  const auto visible_entities = occlusion_raycaster.getVisiblePrimitives(
+    origin, names, configuration_.occlusion_ray_budget(), ego->name());
+  return {visible_entities.begin(), visible_entities.end()};
+}
+
 template <>
 void DetectionSensor<autoware_auto_perception_msgs::msg::PredictedObjects>::update(
-  const double current_time, const std::vector<traffic_simulator_msgs::EntityStatus> & status,
-  const rclcpp::Time & stamp, const std::vector<std::string> & detected_objects)
+  const std::vector<traffic_simulator_msgs::EntityStatus> & status,
+  const EntityIndex & entity_index, const rclcpp::Time & stamp,
+  const std::vector<std::string> & detected_objects, const Raycaster * occlusion_raycaster)
 {
   auto makeObjectClassification = [](const auto & label) {
     autoware_auto_perception_msgs::msg::ObjectClassification object_classification;
@@ -40,50 +141,52 @@ void DetectionSensor<autoware_auto_perception_msgs::msg::PredictedObjects>::upda
     return object_classification;
   };
 
-  if (current_time - last_update_stamp_ - configuration_.update_duration() >= -0.002) {
-    autoware_auto_perception_msgs::msg::PredictedObjects msg;
-    msg.header.stamp = stamp;
-    msg.header.frame_id = "map";
-    last_update_stamp_ = current_time;
-    for (const auto & s : status) {
-      auto result = std::find(detected_objects.begin(), detected_objects.end(), s.name());
-      if (result != detected_objects.end()) {
-        autoware_auto_perception_msgs::msg::PredictedObject object;
-        bool is_ego = false;
-        switch (s.type()) {
-          case traffic_simulator_msgs::EntityType::EGO:
-            is_ego = true;
-            break;
-          case traffic_simulator_msgs::EntityType::VEHICLE:
-            object.classification.push_back(makeObjectClassification(
-              autoware_auto_perception_msgs::msg::ObjectClassification::CAR));
-            break;
-          case traffic_simulator_msgs::EntityType::PEDESTRIAN:
-            object.classification.push_back(makeObjectClassification(
-              autoware_auto_perception_msgs::msg::ObjectClassification::PEDESTRIAN));
-            break;
-          case traffic_simulator_msgs::EntityType::MISC_OBJECT:
-            break;
-          default:
-            throw SimulationRuntimeError("unsupported entity type!");
-            break;
-        }
-        if (not is_ego) {
-          simulation_interface::toMsg(s.bounding_box().dimensions(), object.shape.dimensions);
-          geometry_msgs::msg::Pose pose;
-          simulation_interface::toMsg(s.pose(), pose);
-          object.kinematics.initial_pose_with_covariance.pose = pose;
-          object.kinematics.initial_pose_with_covariance.covariance = {
-            1, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0,
-            0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 1};
-          simulation_interface::toMsg(
-            s.action_status().twist(), object.kinematics.initial_twist_with_covariance.twist);
-          object.shape.type = object.shape.BOUNDING_BOX;
-          msg.objects.emplace_back(object);
-        }
+  autoware_auto_perception_msgs::msg::PredictedObjects msg;
+  msg.header.stamp = stamp;
+  msg.header.frame_id = "map";
+  const auto entities = getEntitiesInView(status, entity_index);
+  const auto detected_names =
+    isOcclusionMode() && occlusion_raycaster
+      ? getVisibleEntities(status, entity_index, entities, *occlusion_raycaster)
+      : std::unordered_set<std::string>(detected_objects.begin(), detected_objects.end());
+  for (const auto i : entities) {
+    const auto & s = status[i];
+    if (detected_names.count(s.name()) != 0) {
+      autoware_auto_perception_msgs::msg::PredictedObject object;
+      bool is_ego = false;
+      switch (s.type()) {
+        case traffic_simulator_msgs::EntityType::EGO:
+          is_ego = true;
+          break;
+        case traffic_simulator_msgs::EntityType::VEHICLE:
+          object.classification.push_back(makeObjectClassification(
+            autoware_auto_perception_msgs::msg::ObjectClassification::CAR));
+          break;
+        case traffic_simulator_msgs::EntityType::PEDESTRIAN:
+          object.classification.push_back(makeObjectClassification(
+            autoware_auto_perception_msgs::msg::ObjectClassification::PEDESTRIAN));
+          break;
+        case traffic_simulator_msgs::EntityType::MISC_OBJECT:
+          break;
+        default:
+          throw SimulationRuntimeError("unsupported entity type!");
+          break;
+      }
+      if (not is_ego) {
+        simulation_interface::toMsg(s.bounding_box().dimensions(), object.shape.dimensions);
+        geometry_msgs::msg::Pose pose;
+        simulation_interface::toMsg(s.pose(), pose);
+        object.kinematics.initial_pose_with_covariance.pose = pose;
+        object.kinematics.initial_pose_with_covariance.covariance = {
+          1, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0,
+          0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 1};
+        simulation_interface::toMsg(
+          s.action_status().twist(), object.kinematics.initial_twist_with_covariance.twist);
+        object.shape.type = object.shape.BOUNDING_BOX;
+        msg.objects.emplace_back(object);
       }
     }
-    publisher_ptr_->publish(msg);
   }
+  publisher_ptr_->publish(msg);
 }
 }  // namespace simple_sensor_simulator
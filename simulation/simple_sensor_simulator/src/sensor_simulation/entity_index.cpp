@@ -0,0 +1,101 @@
+// Copyright 2015-2020 Tier IV, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <quaternion_operation/quaternion_operation.h>
+
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+#include <simple_sensor_simulator/sensor_simulation/entity_index.hpp>
+#include <simulation_interface/conversions.hpp>
+#include <vector>
+
+namespace simple_sensor_simulator
+{
+EntityIndex::EntityIndex(
+  const std::vector<traffic_simulator_msgs::EntityStatus> & status, double cell_size)
+: cell_size_(cell_size)
+{
+  centers_.reserve(status.size());
+  bounding_radii_.reserve(status.size());
+  for (const auto & s : status) {
+    geometry_msgs::msg::Pose pose;
+    simulation_interface::toMsg(s.pose(), pose);
+    geometry_msgs::msg::Point center_point;
+    simulation_interface::toMsg(s.bounding_box().center(), center_point);
+    const Eigen::Vector3d center =
+      quaternion_operation::getRotationMatrix(pose.orientation) *
+        Eigen::Vector3d(center_point.x, center_point.y, center_point.z) +
+      Eigen::Vector3d(pose.position.x, pose.position.y, pose.position.z);
+    const auto & dimensions = s.bounding_box().dimensions();
+    const double bounding_radius =
+      0.5 * std::sqrt(
+              dimensions.x() * dimensions.x() + dimensions.y() * dimensions.y() +
+              dimensions.z() * dimensions.z());
+    cells_[getCellKey(getCellIndex(center.x()), getCellIndex(center.y()))].emplace_back(
+      centers_.size());
+    centers_.emplace_back(center);
+    bounding_radii_.emplace_back(bounding_radius);
+    max_bounding_radius_ = std::max(max_bounding_radius_, bounding_radius);
+  }
+}
+
+auto EntityIndex::getCellIndex(double value) const -> std::int64_t
+{
+  return static_cast<std::int64_t>(std::floor(value / cell_size_));
+}
+
+auto EntityIndex::getCellKey(std::int64_t column, std::int64_t row) -> std::int64_t
+{
+  return static_cast<std::int64_t>(
+    (static_cast<std::uint64_t>(column) << 32) ^ (static_cast<std::uint64_t>(row) & 0xFFFFFFFF));
+}
+
+auto EntityIndex::query(const Eigen::Vector3d & center, double radius) const
+  -> std::vector<std::size_t>
+{
+  const auto overlaps = [&](std::size_t i) {
+    return (centers_[i] - center).head<2>().norm() - bounding_radii_[i] <= radius;
+  };
+  std::vector<std::size_t> ret;
+  // Entities are registered in the cell of their center only, so the search area is enlarged by
+  // the largest bounding radius.
+  const auto search_radius = radius + max_bounding_radius_;
+  const auto min_column = getCellIndex(center.x() - search_radius);
+  const auto max_column = getCellIndex(center.x() + search_radius);
+  const auto min_row = getCellIndex(center.y() - search_radius);
+  const auto max_row = getCellIndex(center.y() + search_radius);
+  if (
+    (max_column - min_column + 1) * (max_row - min_row + 1) >
+    static_cast<std::int64_t>(cells_.size())) {
+    for (std::size_t i = 0; i < size(); i++) {
+      if (overlaps(i)) {
+        ret.emplace_back(i);
+      }
+    }
+    return ret;
+  }
+  for (auto column = min_column; column <= max_column; column++) {
+    for (auto row = min_row; row <= max_row; row++) {
+      const auto iter = cells_.find(getCellKey(column, row));
+      if (iter != cells_.end()) {
+        std::copy_if(
+          iter->second.begin(), iter->second.end(), std::back_inserter(ret), overlaps);
+      }
+    }
+  }
+  std::sort(ret.begin(), ret.end());
+  return ret;
+}
+}  // namespace simple_sensor_simulator
@@ -15,6 +15,7 @@
 #include <quaternion_operation/quaternion_operation.h>
 
 #include <boost/optional.hpp>
+#include <cmath>
 #include <memory>
 #include <simple_sensor_simulator/exception.hpp>
 #include <simple_sensor_simulator/sensor_simulation/lidar/lidar_sensor.hpp>
@@ -25,44 +26,65 @@
 
 namespace simple_sensor_simulator
 {
+auto LidarSensorBase::isInFieldOfView(
+  const Eigen::Vector3d & position, double bounding_radius) const -> bool
+{
+  const auto distance = position.norm();
+  if (distance <= bounding_radius) {
+    return true;
+  }
+  const auto elevation = std::atan2(position.z(), position.head<2>().norm());
+  const auto angular_radius = std::asin(bounding_radius / distance);
+  return min_elevation_ <= elevation + angular_radius &&
+         elevation - angular_radius <= max_elevation_;
+}
+
 template <>
 auto LidarSensor<sensor_msgs::msg::PointCloud2>::raycast(
-  const std::vector<traffic_simulator_msgs::EntityStatus> & status, const rclcpp::Time & stamp)
-  -> sensor_msgs::msg::PointCloud2
+  const std::vector<traffic_simulator_msgs::EntityStatus> & status,
+  const EntityIndex & entity_index, const rclcpp::Time & stamp,
+  sensor_msgs::msg::PointCloud2 & pointcloud_msg) -> void
 {
-  Raycaster raycaster;
   boost::optional<geometry_msgs::msg::Pose> ego_pose;
   for (const auto & s : status) {
     if (configuration_.entity() == s.name()) {
       geometry_msgs::msg::Pose pose;
       simulation_interface::toMsg(s.pose(), pose);
       ego_pose = pose;
-    } else {
-      geometry_msgs::msg::Pose pose;
-      simulation_interface::toMsg(s.pose(), pose);
-      auto rotation = quaternion_operation::getRotationMatrix(pose.orientation);
-      geometry_msgs::msg::Point center_point;
-      simulation_interface::toMsg(s.bounding_box().center(), center_point);
-      Eigen::Vector3d center(center_point.x, center_point.y, center_point.z);
-      center = rotation * center;
-      pose.position.x = pose.position.x + center.x();
-      pose.position.y = pose.position.y + center.y();
-      pose.position.z = pose.position.z + center.z();
-      raycaster.addPrimitive<simple_sensor_simulator::primitives::Box>(
-        s.name(), s.bounding_box().dimensions().x(), s.bounding_box().dimensions().y(),
-        s.bounding_box().dimensions().z(), pose);
+      break;
     }
   }
-  if (ego_pose) {
-    std::vector<double> vertical_angles;
-    for (const auto v : configuration_.vertical_angles()) {
-      vertical_angles.emplace_back(v);
+  if (!ego_pose) {
+    throw simple_sensor_simulator::SimulationRuntimeError("failed to found ego vehicle");
+  }
+  const auto rotation = quaternion_operation::getRotationMatrix(ego_pose->orientation);
+  const Eigen::Vector3d origin =
+    Eigen::Vector3d(ego_pose->position.x, ego_pose->position.y, ego_pose->position.z) +
+    rotation * Eigen::Vector3d(0, 0, configuration_.mounting_height());
+  const auto candidates = entity_index.query(origin, getRange());
+  cull_statistics_.entities += status.size() - 1;
+  cull_statistics_.culled_by_range += status.size() - candidates.size();
+  for (const auto i : candidates) {
+    const auto & s = status[i];
+    if (configuration_.entity() == s.name()) {
+      continue;
+    }
+    const auto & center = entity_index.getCenter(i);
+    if (!isInFieldOfView(
+          rotation.transpose() * (center - origin), entity_index.getBoundingRadius(i))) {
+      cull_statistics_.culled_by_fov++;
+      continue;
     }
-    const auto pointcloud = raycaster.raycast(
-      "base_link", stamp, ego_pose.get(), configuration_.horizontal_resolution(), vertical_angles);
-    detected_objects_ = raycaster.getDetectedObject();
-    return pointcloud;
+    geometry_msgs::msg::Pose pose;
+    simulation_interface::toMsg(s.pose(), pose);
+    pose.position.x = center.x();
+    pose.position.y = center.y();
+    pose.position.z = center.z();
+    raycaster_.addPrimitive<simple_sensor_simulator::primitives::Box>(
+      s.name(), s.bounding_box().dimensions().x(), s.bounding_box().dimensions().y(),
+      s.bounding_box().dimensions().z(), pose);
   }
-  throw simple_sensor_simulator::SimulationRuntimeError("failed to found ego vehicle");
+  raycaster_.raycast("base_link", stamp, ego_pose.get(), pointcloud_msg, getRange());
+  detected_objects_ = raycaster_.getDetectedObject();
 }
 }  // namespace simple_sensor_simulator
@@ -15,7 +15,11 @@
 #include <quaternion_operation/quaternion_operation.h>
 
 #include <algorithm>
+#include <cstddef>
+#include <cstring>
 #include <iostream>
+#include <memory>
+#include <simple_sensor_simulator/exception.hpp>
 #include <simple_sensor_simulator/sensor_simulation/lidar/lidar_sensor.hpp>
 #include <simple_sensor_simulator/sensor_simulation/lidar/raycaster.hpp>
 #include <string>
@@ -25,25 +29,117 @@
 
 namespace simple_sensor_simulator
 {
-Raycaster::Raycaster() : primitive_ptrs_(0), device_(nullptr), scene_(nullptr), engine_(seed_gen_())
+RaycastDevice::RaycastDevice() : device_(rtcNewDevice(nullptr)) {}
+
+RaycastDevice::RaycastDevice(const std::string & embree_config)
+: device_(rtcNewDevice(embree_config.c_str()))
 {
-  device_ = rtcNewDevice(nullptr);
 }
 
+RaycastDevice::~RaycastDevice()
+{
+  if (static_scene_) {
+    rtcReleaseScene(static_scene_);
+  }
+  rtcReleaseDevice(device_);
+}
+
+void RaycastDevice::setStaticPrimitive(const primitives::Primitive & primitive)
+{
+  if (static_scene_) {
+    rtcReleaseScene(static_scene_);
+  }
+  static_scene_ = primitive.createLocalScene(device_);
+  static_transform_ = primitive.getTransform();
+}
+
+Raycaster::Raycaster() : Raycaster(std::make_shared<const RaycastDevice>()) {}
+
 Raycaster::Raycaster(std::string embree_config)
-: primitive_ptrs_(0), device_(nullptr), scene_(nullptr), engine_(seed_gen_())
+: Raycaster(std::make_shared<const RaycastDevice>(embree_config))
+{
+}
+
+Raycaster::Raycaster(const std::shared_ptr<const RaycastDevice> & device)
+: device_(device), scene_(nullptr), engine_(seed_gen_())
 {
-  device_ = rtcNewDevice(embree_config.c_str());
+  ray_packet_size_ = selectRayPacketSize(device_->get());
+  scene_ = rtcNewScene(device_->get());
+  rtcSetSceneFlags(scene_, RTC_SCENE_FLAG_DYNAMIC);
+  rtcSetSceneBuildQuality(scene_, RTC_BUILD_QUALITY_LOW);
+  if (device_->getStaticScene()) {
+    static_instance_.local_scene = device_->getStaticScene();
+    rtcRetainScene(static_instance_.local_scene);
+    static_instance_.geometry = rtcNewGeometry(device_->get(), RTC_GEOMETRY_TYPE_INSTANCE);
+    rtcSetGeometryInstancedScene(static_instance_.geometry, static_instance_.local_scene);
+    rtcSetGeometryTransform(
+      static_instance_.geometry, 0, RTC_FORMAT_FLOAT3X4_COLUMN_MAJOR,
+      device_->getStaticTransform().data());
+    rtcCommitGeometry(static_instance_.geometry);
+    static_instance_.geometry_id = rtcAttachGeometry(scene_, static_instance_.geometry);
+  }
 }
 
-Raycaster::~Raycaster() { rtcReleaseDevice(device_); }
+Raycaster::~Raycaster()
+{
+  for (auto & instance : instances_) {
+    releaseInstance(instance.second);
+  }
+  releaseInstance(static_instance_);
+  rtcReleaseScene(scene_);
+}
 
-const sensor_msgs::msg::PointCloud2 Raycaster::raycast(
-  std::string frame_id, const rclcpp::Time & stamp, geometry_msgs::msg::Pose origin,
-  double horizontal_resolution, std::vector<double> vertical_angles, double horizontal_angle_start,
-  double horizontal_angle_end, double max_distance, double min_distance)
+void Raycaster::updateInstance(
+  const std::string & name, Instance & instance,
+  std::unique_ptr<primitives::Primitive> primitive_ptr)
+{
+  if (!instance.primitive_ptr || !instance.primitive_ptr->hasSameShape(*primitive_ptr)) {
+    releaseInstance(instance);
+    instance.local_scene = primitive_ptr->createLocalScene(device_->get());
+    instance.geometry = rtcNewGeometry(device_->get(), RTC_GEOMETRY_TYPE_INSTANCE);
+    rtcSetGeometryInstancedScene(instance.geometry, instance.local_scene);
+    instance.geometry_id = rtcAttachGeometry(scene_, instance.geometry);
+    geometry_ids_[instance.geometry_id] = name;
+  }
+  const auto transform = primitive_ptr->getTransform();
+  rtcSetGeometryTransform(instance.geometry, 0, RTC_FORMAT_FLOAT3X4_COLUMN_MAJOR, transform.data());
+  rtcCommitGeometry(instance.geometry);
+  instance.primitive_ptr = std::move(primitive_ptr);
+  instance.added = true;
+}
+
+void Raycaster::releaseInstance(Instance & instance)
 {
-  std::vector<geometry_msgs::msg::Quaternion> directions;
+  if (instance.geometry) {
+    rtcDetachGeometry(scene_, instance.geometry_id);
+    geometry_ids_.erase(instance.geometry_id);
+    rtcReleaseGeometry(instance.geometry);
+    rtcReleaseScene(instance.local_scene);
+    instance.geometry = nullptr;
+    instance.local_scene = nullptr;
+    instance.geometry_id = RTC_INVALID_GEOMETRY_ID;
+  }
+}
+
+void Raycaster::commitScene()
+{
+  for (auto iter = instances_.begin(); iter != instances_.end();) {
+    if (iter->second.added) {
+      iter->second.added = false;
+      iter++;
+    } else {
+      releaseInstance(iter->second);
+      iter = instances_.erase(iter);
+    }
+  }
+  rtcCommitScene(scene_);
+}
+
+void Raycaster::setDirections(
+  double horizontal_resolution, const std::vector<double> & vertical_angles,
+  double horizontal_angle_start, double horizontal_angle_end)
+{
+  std::vector<Eigen::Vector3f> directions;
   double horizontal_angle = horizontal_angle_start;
   while (horizontal_angle <= (horizontal_angle_end)) {
     horizontal_angle = horizontal_angle + horizontal_resolution;
@@ -52,70 +148,304 @@ const sensor_msgs::msg::PointCloud2 Raycaster::raycast(
       rpy.x = 0;
       rpy.y = vertical_angle;
       rpy.z = horizontal_angle;
-      auto quat = quaternion_operation::convertEulerAngleToQuaternion(rpy);
-      directions.emplace_back(quat);
+      const auto quat = quaternion_operation::convertEulerAngleToQuaternion(rpy);
+      const Eigen::Vector3d direction =
+        quaternion_operation::getRotationMatrix(quat) * Eigen::Vector3d(1.0, 0.0, 0.0);
+      directions.emplace_back(direction.cast<float>());
     }
   }
-  return raycast(frame_id, stamp, origin, directions, max_distance, min_distance);
+  direction_table_.resize(3, directions.size());
+  for (size_t i = 0; i < directions.size(); i++) {
+    direction_table_.col(i) = directions[i];
+  }
+}
+
+const sensor_msgs::msg::PointCloud2 Raycaster::raycast(
+  std::string frame_id, const rclcpp::Time & stamp, geometry_msgs::msg::Pose origin,
+  double horizontal_resolution, std::vector<double> vertical_angles, double horizontal_angle_start,
+  double horizontal_angle_end, double max_distance, double min_distance)
+{
+  setDirections(
+    horizontal_resolution, vertical_angles, horizontal_angle_start, horizontal_angle_end);
+  return raycast(frame_id, stamp, origin, max_distance, min_distance);
 }
 
 const std::vector<std::string> & Raycaster::getDetectedObject() const { return detected_objects_; }
 
+std::vector<std::string> Raycaster::getVisiblePrimitives(
+  const geometry_msgs::msg::Point & origin, const std::vector<std::string> & names,
+  size_t ray_budget, const std::string & excluded) const
+{
+  const auto excluded_instance = instances_.find(excluded);
+  const auto excluded_id = excluded_instance == instances_.end()
+                             ? RTC_INVALID_GEOMETRY_ID
+                             : excluded_instance->second.geometry_id;
+  std::vector<std::string> visible_primitives;
+  // Each query has a context of its own, so that queries on other threads share no state.
+  RTCIntersectContext context;
+  rtcInitIntersectContext(&context);
+  for (const auto & name : names) {
+    const auto instance = instances_.find(name);
+    if (instance == instances_.end() || name == excluded) {
+      continue;
+    }
+    for (const auto & sample : instance->second.primitive_ptr->getSamplePoints(ray_budget)) {
+      // The direction is not normalized, so the ray reaches the sample point at t = 1.
+      RTCRayHit rayhit;
+      rayhit.ray.org_x = origin.x;
+      rayhit.ray.org_y = origin.y;
+      rayhit.ray.org_z = origin.z;
+      rayhit.ray.dir_x = sample.x - origin.x;
+      rayhit.ray.dir_y = sample.y - origin.y;
+      rayhit.ray.dir_z = sample.z - origin.z;
+      rayhit.ray.tnear = 0;
+      rayhit.ray.tfar = 1;
+      rayhit.ray.time = 0;
+      rayhit.ray.mask = -1;
+      rayhit.ray.flags = 0;
+      rayhit.hit.geomID = RTC_INVALID_GEOMETRY_ID;
+      rayhit.hit.instID[0] = RTC_INVALID_GEOMETRY_ID;
+      rtcIntersect1(scene_, &context, &rayhit);
+      // The origin is usually inside the excluded primitive, so the ray goes on past its faces.
+      while (excluded_id != RTC_INVALID_GEOMETRY_ID && rayhit.hit.instID[0] == excluded_id) {
+        rayhit.ray.tnear = rayhit.ray.tfar + 1e-4f;
+        rayhit.ray.tfar = 1;
+        rayhit.hit.geomID = RTC_INVALID_GEOMETRY_ID;
+        rayhit.hit.instID[0] = RTC_INVALID_GEOMETRY_ID;
+        rtcIntersect1(scene_, &context, &rayhit);
+      }
+      if (
+        rayhit.hit.instID[0] == RTC_INVALID_GEOMETRY_ID ||
+        rayhit.hit.instID[0] == instance->second.geometry_id) {
+        visible_primitives.emplace_back(instance->first);
+        break;
+      }
+    }
+  }
+  return visible_primitives;
+}
+
+auto Raycaster::selectRayPacketSize(RTCDevice device) -> size_t
+{
+  if (rtcGetDeviceProperty(device, RTC_DEVICE_PROPERTY_NATIVE_RAY16_SUPPORTED)) {
+    return 16;
+  } else if (rtcGetDeviceProperty(device, RTC_DEVICE_PROPERTY_NATIVE_RAY8_SUPPORTED)) {
+    return 8;
+  } else if (rtcGetDeviceProperty(device, RTC_DEVICE_PROPERTY_NATIVE_RAY4_SUPPORTED)) {
+    return 4;
+  } else {
+    return 1;
+  }
+}
+
+void Raycaster::setRayPacketSize(size_t ray_packet_size)
+{
+  if (
+    ray_packet_size != 1 && ray_packet_size != 4 && ray_packet_size != 8 &&
+    ray_packet_size != 16) {
+    throw SimulationRuntimeError("ray packet size must be 1, 4, 8 or 16");
+  }
+  ray_packet_size_ = ray_packet_size;
+}
+
+namespace
+{
+/**
+ * @note The rays of a packet are initialized exactly as the single rays of rtcIntersect1 are, so
+ * that both paths return the same hits.
+ */
+template <typename RayHitN, size_t N, typename Hit>
+void intersectPackets(
+  void (*intersectN)(const int *, RTCScene, RTCIntersectContext *, RayHitN *), RTCScene scene,
+  const geometry_msgs::msg::Point & origin, const Eigen::Matrix3Xf & directions,
+  float max_distance, float min_distance, size_t first, size_t last, std::vector<Hit> & hits)
+{
+  RTCIntersectContext context;
+  rtcInitIntersectContext(&context);
+  alignas(64) int valid[N];
+  RayHitN rayhit;
+  for (size_t begin = first; begin < last; begin += N) {
+    for (size_t i = 0; i < N; i++) {
+      const auto index = begin + i;
+      if (index < last) {
+        valid[i] = -1;
+        rayhit.ray.org_x[i] = origin.x;
+        rayhit.ray.org_y[i] = origin.y;
+        rayhit.ray.org_z[i] = origin.z;
+        rayhit.ray.tfar[i] = max_distance;
+        rayhit.ray.tnear[i] = min_distance;
+        rayhit.ray.time[i] = 0;
+        rayhit.ray.mask[i] = -1;
+        rayhit.ray.flags[i] = 0;
+        rayhit.ray.dir_x[i] = directions(0, index);
+        rayhit.ray.dir_y[i] = directions(1, index);
+        rayhit.ray.dir_z[i] = directions(2, index);
+        rayhit.hit.geomID[i] = RTC_INVALID_GEOMETRY_ID;
+        rayhit.hit.instID[0][i] = RTC_INVALID_GEOMETRY_ID;
+      } else {
+        valid[i] = 0;
+      }
+    }
+    intersectN(valid, scene, &context, &rayhit);
+    for (size_t i = 0; i < N && begin + i < last; i++) {
+      hits[begin + i].geometry_id = rayhit.hit.geomID[i];
+      hits[begin + i].instance_id = rayhit.hit.instID[0][i];
+      hits[begin + i].distance = rayhit.ray.tfar[i];
+    }
+  }
+}
+}  // namespace
+
+auto Raycaster::intersect(
+  const geometry_msgs::msg::Point & origin, const Eigen::Matrix3Xf & directions,
+  double max_distance, double min_distance) -> std::vector<Hit>
+{
+  std::vector<Hit> hits(directions.cols());
+  if (!thread_pool_ || thread_pool_->size() == 1 || hits.empty()) {
+    intersect(origin, directions, max_distance, min_distance, 0, hits.size(), hits);
+    return hits;
+  }
+  // The directions are sorted by horizontal angle, so each sector is an angular sector of the scan.
+  // Every sector writes only its own hits, so the result does not depend on the number of threads.
+  const size_t sectors = thread_pool_->size() * 4;
+  const size_t sector_size =
+    ((hits.size() + sectors - 1) / sectors + ray_packet_size_ - 1) / ray_packet_size_ *
+    ray_packet_size_;
+  const size_t sector_count = (hits.size() + sector_size - 1) / sector_size;
+  thread_pool_->parallelFor(sector_count, [&](size_t sector) {
+    const auto first = sector * sector_size;
+    const auto last = std::min(first + sector_size, hits.size());
+    intersect(origin, directions, max_distance, min_distance, first, last, hits);
+  });
+  return hits;
+}
+
+void Raycaster::intersect(
+  const geometry_msgs::msg::Point & origin, const Eigen::Matrix3Xf & directions,
+  double max_distance, double min_distance, size_t first, size_t last,
+  std::vector<Hit> & hits) const
+{
+  switch (ray_packet_size_) {
+    case 16:
+      intersectPackets<RTCRayHit16, 16>(
+        rtcIntersect16, scene_, origin, directions, max_distance, min_distance, first, last, hits);
+      break;
+    case 8:
+      intersectPackets<RTCRayHit8, 8>(
+        rtcIntersect8, scene_, origin, directions, max_distance, min_distance, first, last, hits);
+      break;
+    case 4:
+      intersectPackets<RTCRayHit4, 4>(
+        rtcIntersect4, scene_, origin, directions, max_distance, min_distance, first, last, hits);
+      break;
+    default: {
+      RTCIntersectContext context;
+      rtcInitIntersectContext(&context);
+      for (size_t i = first; i < last; i++) {
+        RTCRayHit rayhit;
+        rayhit.ray.org_x = origin.x;
+        rayhit.ray.org_y = origin.y;
+        rayhit.ray.org_z = origin.z;
+        rayhit.ray.tfar = max_distance;
+        rayhit.ray.tnear = min_distance;
+        rayhit.ray.time = 0;
+        rayhit.ray.mask = -1;
+        rayhit.ray.flags = 0;
+        rayhit.ray.dir_x = directions(0, i);
+        rayhit.ray.dir_y = directions(1, i);
+        rayhit.ray.dir_z = directions(2, i);
+        rayhit.hit.geomID = RTC_INVALID_GEOMETRY_ID;
+        rayhit.hit.instID[0] = RTC_INVALID_GEOMETRY_ID;
+        rtcIntersect1(scene_, &context, &rayhit);
+        hits[i].geometry_id = rayhit.hit.geomID;
+        hits[i].instance_id = rayhit.hit.instID[0];
+        hits[i].distance = rayhit.ray.tfar;
+      }
+      break;
+    }
+  }
+}
+
 const sensor_msgs::msg::PointCloud2 Raycaster::raycast(
   std::string frame_id, const rclcpp::Time & stamp, geometry_msgs::msg::Pose origin,
-  std::vector<geometry_msgs::msg::Quaternion> directions, double max_distance, double min_distance)
+  double max_distance, double min_distance)
+{
+  sensor_msgs::msg::PointCloud2 pointcloud_msg;
+  raycast(frame_id, stamp, origin, pointcloud_msg, max_distance, min_distance);
+  return pointcloud_msg;
+}
+
+namespace
+{
+auto makePointField(const std::string & name, uint32_t offset) -> sensor_msgs::msg::PointField
+{
+  sensor_msgs::msg::PointField field;
+  field.name = name;
+  field.offset = offset;
+  field.datatype = sensor_msgs::msg::PointField::FLOAT32;
+  field.count = 1;
+  return field;
+}
+}  // namespace
+
+void Raycaster::raycast(
+  const std::string & frame_id, const rclcpp::Time & stamp, const geometry_msgs::msg::Pose & origin,
+  sensor_msgs::msg::PointCloud2 & pointcloud_msg, double max_distance, double min_distance)
 {
   detected_objects_ = {};
   std::vector<unsigned int> detected_ids = {};
-  scene_ = rtcNewScene(device_);
-  pcl::PointCloud<pcl::PointXYZI>::Ptr cloud(new pcl::PointCloud<pcl::PointXYZI>());
-  for (auto & pair : primitive_ptrs_) {
-    auto id = pair.second->addToScene(device_, scene_);
-    geometry_ids_.insert({id, pair.first});
+  commitScene();
+  const Eigen::Matrix3f rotation =
+    quaternion_operation::getRotationMatrix(origin.orientation).cast<float>();
+  const Eigen::Matrix3Xf ray_directions = rotation * direction_table_;
+  const Eigen::Vector3f sensor_offset = rotation * sensor_position_;
+  geometry_msgs::msg::Point sensor_position = origin.position;
+  sensor_position.x += sensor_offset.x();
+  sensor_position.y += sensor_offset.y();
+  sensor_position.z += sensor_offset.z();
+  const auto hits = intersect(sensor_position, ray_directions, max_distance, min_distance);
+  const auto point_count = std::count_if(hits.begin(), hits.end(), [](const auto & hit) {
+    return hit.geometry_id != RTC_INVALID_GEOMETRY_ID;
+  });
+  // Same layout as pcl::toROSMsg of a pcl::PointCloud<pcl::PointXYZI>.
+  if (pointcloud_msg.fields.size() != 4) {
+    pointcloud_msg.fields = {
+      makePointField("x", offsetof(pcl::PointXYZI, x)),
+      makePointField("y", offsetof(pcl::PointXYZI, y)),
+      makePointField("z", offsetof(pcl::PointXYZI, z)),
+      makePointField("intensity", offsetof(pcl::PointXYZI, intensity))};
   }
-  rtcCommitScene(scene_);
-  RTCIntersectContext context;
-  rtcInitIntersectContext(&context);
-  for (const auto & direction : directions) {
-    RTCRayHit rayhit;
-    rayhit.ray.org_x = origin.position.x;
-    rayhit.ray.org_y = origin.position.y;
-    rayhit.ray.org_z = origin.position.z;
-    rayhit.ray.tfar = max_distance;
-    rayhit.ray.tnear = min_distance;
-    rayhit.ray.flags = false;
-    const auto ray_direction = origin.orientation * direction;
-    const auto rotation_mat = quaternion_operation::getRotationMatrix(ray_direction);
-    const Eigen::Vector3d rotated_direction = rotation_mat * Eigen::Vector3d(1.0, 0.0, 0.0);
-    rayhit.ray.dir_x = rotated_direction[0];
-    rayhit.ray.dir_y = rotated_direction[1];
-    rayhit.ray.dir_z = rotated_direction[2];
-    rayhit.hit.geomID = RTC_INVALID_GEOMETRY_ID;
-    rtcIntersect1(scene_, &context, &rayhit);
-    if (rayhit.hit.geomID != RTC_INVALID_GEOMETRY_ID) {
-      double distance = rayhit.ray.tfar;
-      const Eigen::Vector3d vector = quaternion_operation::getRotationMatrix(direction) *
-                                     Eigen::Vector3d(1.0, 0.0, 0.0) * distance;
+  pointcloud_msg.header.frame_id = frame_id;
+  pointcloud_msg.header.stamp = stamp;
+  pointcloud_msg.height = 1;
+  pointcloud_msg.width = point_count;
+  pointcloud_msg.is_bigendian = false;
+  pointcloud_msg.point_step = sizeof(pcl::PointXYZI);
+  pointcloud_msg.row_step = pointcloud_msg.point_step * pointcloud_msg.width;
+  pointcloud_msg.is_dense = true;
+  pointcloud_msg.data.resize(pointcloud_msg.row_step);
+  auto data = pointcloud_msg.data.data();
+  for (size_t i = 0; i < hits.size(); i++) {
+    if (hits[i].geometry_id != RTC_INVALID_GEOMETRY_ID) {
+      const Eigen::Vector3f vector = direction_table_.col(i) * hits[i].distance + sensor_position_;
       pcl::PointXYZI p;
       {
         p.x = vector[0];
         p.y = vector[1];
         p.z = vector[2];
       }
-      cloud->emplace_back(p);
-      if (std::count(detected_ids.begin(), detected_ids.end(), rayhit.hit.geomID) == 0) {
-        detected_ids.emplace_back(rayhit.hit.geomID);
+      std::memcpy(data, &p, sizeof(p));
+      data += sizeof(p);
+      const auto instance_id = hits[i].instance_id;
+      if (
+        instance_id != static_instance_.geometry_id &&
+        std::count(detected_ids.begin(), detected_ids.end(), instance_id) == 0) {
+        detected_ids.emplace_back(instance_id);
       }
     }
   }
   for (const auto & id : detected_ids) {
     detected_objects_.emplace_back(geometry_ids_[id]);
   }
-  sensor_msgs::msg::PointCloud2 pointcloud_msg;
-  pcl::toROSMsg(*cloud, pointcloud_msg);
-  rtcReleaseScene(scene_);
-  pointcloud_msg.header.frame_id = frame_id;
-  pointcloud_msg.header.stamp = stamp;
-  return pointcloud_msg;
 }
 }  // namespace simple_sensor_simulator
@@ -0,0 +1,160 @@
+// Copyright 2015-2020 Tier IV, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <lanelet2_io/Io.h>
+
+#include <lanelet2_extension_psim/projection/mgrs_projector.hpp>
+#include <simple_sensor_simulator/exception.hpp>
+#include <simple_sensor_simulator/sensor_simulation/primitives/lanelet_map.hpp>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace simple_sensor_simulator
+{
+namespace primitives
+{
+namespace
+{
+geometry_msgs::msg::Pose identity()
+{
+  geometry_msgs::msg::Pose pose;
+  pose.orientation.w = 1;
+  return pose;
+}
+
+Vertex toVertex(const lanelet::ConstPoint3d & point)
+{
+  Vertex vertex;
+  vertex.x = point.x();
+  vertex.y = point.y();
+  vertex.z = point.z();
+  return vertex;
+}
+
+template <typename T>
+std::vector<Vertex> toVertices(const T & points)
+{
+  std::vector<Vertex> ret;
+  for (const auto & point : points) {
+    ret.emplace_back(toVertex(point));
+  }
+  return ret;
+}
+
+std::vector<double> getNormalizedArcLength(const lanelet::ConstLineString3d & line_string)
+{
+  std::vector<double> ret = {0};
+  for (size_t i = 1; i < line_string.size(); i++) {
+    const auto segment = line_string[i].basicPoint() - line_string[i - 1].basicPoint();
+    ret.emplace_back(ret.back() + segment.norm());
+  }
+  const auto length = ret.back();
+  for (auto & s : ret) {
+    s = length > 0 ? s / length : 0;
+  }
+  return ret;
+}
+}  // namespace
+
+LaneletMap::LaneletMap(const std::string & lanelet2_map_path) : Primitive("LaneletMap", identity())
+{
+  lanelet::projection::MGRSProjector projector;
+  lanelet::ErrorMessages errors;
+  const auto lanelet_map_ptr = lanelet::load(lanelet2_map_path, projector, &errors);
+  if (!errors.empty()) {
+    std::stringstream ss;
+    ss << "failed to load lanelet map " << lanelet2_map_path << ":";
+    for (const auto & error : errors) {
+      ss << "\n" << error;
+    }
+    throw SimulationRuntimeError(ss.str());
+  }
+  for (const auto & lanelet : lanelet_map_ptr->laneletLayer) {
+    addRoadSurface(lanelet);
+  }
+  const std::unordered_map<std::string, double> wall_heights = {
+    {"curbstone", 0.15}, {"road_border", 0.15}, {"fence", 1.5}, {"wall", 2.0}};
+  for (const auto & line_string : lanelet_map_ptr->lineStringLayer) {
+    if (line_string.hasAttribute(lanelet::AttributeName::Type)) {
+      const auto iter =
+        wall_heights.find(line_string.attribute(lanelet::AttributeName::Type).value());
+      if (iter != wall_heights.end()) {
+        addWall(toVertices(line_string), line_string.attributeOr("height", iter->second));
+      }
+    }
+  }
+  for (const auto & polygon : lanelet_map_ptr->polygonLayer) {
+    if (polygon.hasAttribute("height")) {
+      auto outline = toVertices(polygon);
+      if (!outline.empty()) {
+        outline.emplace_back(outline.front());
+      }
+      addWall(outline, polygon.attributeOr("height", 0.0));
+    }
+  }
+}
+
+void LaneletMap::addRoadSurface(const lanelet::ConstLanelet & lanelet)
+{
+  const auto left = lanelet.leftBound3d();
+  const auto right = lanelet.rightBound3d();
+  if (left.size() < 2 || right.size() < 2) {
+    return;
+  }
+  const unsigned int left_begin = vertices_.size();
+  for (const auto & vertex : toVertices(left)) {
+    vertices_.emplace_back(vertex);
+  }
+  const unsigned int right_begin = vertices_.size();
+  for (const auto & vertex : toVertices(right)) {
+    vertices_.emplace_back(vertex);
+  }
+  // Zip both bounds into a triangle strip, always advancing along the bound that lags behind.
+  const auto left_s = getNormalizedArcLength(left);
+  const auto right_s = getNormalizedArcLength(right);
+  size_t i = 0;
+  size_t j = 0;
+  while (i + 1 < left.size() || j + 1 < right.size()) {
+    Triangle triangle;
+    triangle.v0 = left_begin + i;
+    triangle.v1 = right_begin + j;
+    if (j + 1 == right.size() || (i + 1 < left.size() && left_s[i + 1] <= right_s[j + 1])) {
+      triangle.v2 = left_begin + ++i;
+    } else {
+      triangle.v2 = right_begin + ++j;
+    }
+    triangles_.emplace_back(triangle);
+  }
+}
+
+void LaneletMap::addWall(const std::vector<Vertex> & outline, double height)
+{
+  if (outline.size() < 2 || height <= 0) {
+    return;
+  }
+  const unsigned int begin = vertices_.size();
+  for (const auto & vertex : outline) {
+    vertices_.emplace_back(vertex);
+    vertices_.emplace_back(Vertex{vertex.x, vertex.y, static_cast<float>(vertex.z + height)});
+  }
+  for (unsigned int i = 0; i + 1 < outline.size(); i++) {
+    const auto bottom = begin + 2 * i;
+    triangles_.emplace_back(Triangle{bottom, bottom + 2, bottom + 1});
+    triangles_.emplace_back(Triangle{bottom + 1, bottom + 2, bottom + 3});
+  }
+}
+}  // namespace primitives
+}  // namespace simple_sensor_simulator
@@ -15,6 +15,7 @@
 #include <quaternion_operation/quaternion_operation.h>
 
 #include <algorithm>
+#include <array>
 #include <iostream>
 #include <simple_sensor_simulator/sensor_simulation/primitives/primitive.hpp>
 #include <string>
@@ -57,15 +58,28 @@ std::vector<Vertex> Primitive::getVertex() const { return transform(); }
 
 std::vector<Triangle> Primitive::getTriangles() const { return triangles_; }
 
-unsigned int Primitive::addToScene(RTCDevice device, RTCScene scene)
+std::vector<Vertex> Primitive::getSamplePoints(size_t max_count) const
+{
+  constexpr float scale = 0.9;
+  std::vector<Vertex> ret;
+  if (max_count == 0) {
+    return ret;
+  }
+  ret.emplace_back(transform(Vertex{0, 0, 0}));
+  for (size_t i = 0; i < vertices_.size() && ret.size() < max_count; i++) {
+    const auto & v = vertices_[i % 2 == 0 ? i / 2 : vertices_.size() - 1 - i / 2];
+    ret.emplace_back(transform(Vertex{v.x * scale, v.y * scale, v.z * scale}));
+  }
+  return ret;
+}
+
+RTCGeometry Primitive::createMesh(RTCDevice device, const std::vector<Vertex> & vertices) const
 {
   RTCGeometry mesh = rtcNewGeometry(device, RTC_GEOMETRY_TYPE_TRIANGLE);
-  const auto transformed_vertices = transform();
-  Vertex * vertices = static_cast<Vertex *>(rtcSetNewGeometryBuffer(
-    mesh, RTC_BUFFER_TYPE_VERTEX, 0, RTC_FORMAT_FLOAT3, sizeof(Vertex),
-    transformed_vertices.size()));
-  for (size_t i = 0; i < transformed_vertices.size(); i++) {
-    vertices[i] = transformed_vertices[i];
+  Vertex * vertex_buffer = static_cast<Vertex *>(rtcSetNewGeometryBuffer(
+    mesh, RTC_BUFFER_TYPE_VERTEX, 0, RTC_FORMAT_FLOAT3, sizeof(Vertex), vertices.size()));
+  for (size_t i = 0; i < vertices.size(); i++) {
+    vertex_buffer[i] = vertices[i];
   }
   Triangle * triangles = static_cast<Triangle *>(rtcSetNewGeometryBuffer(
     mesh, RTC_BUFFER_TYPE_INDEX, 0, RTC_FORMAT_UINT3, sizeof(Triangle), triangles_.size()));
@@ -73,9 +87,54 @@ unsigned int Primitive::addToScene(RTCDevice device, RTCScene scene)
     triangles[i] = triangles_[i];
   }
   rtcCommitGeometry(mesh);
+  return mesh;
+}
+
+unsigned int Primitive::addToScene(RTCDevice device, RTCScene scene)
+{
+  RTCGeometry mesh = createMesh(device, transform());
   unsigned int geometry_id = rtcAttachGeometry(scene, mesh);
   rtcReleaseGeometry(mesh);
   return geometry_id;
 }
+
+RTCScene Primitive::createLocalScene(RTCDevice device) const
+{
+  RTCScene scene = rtcNewScene(device);
+  RTCGeometry mesh = createMesh(device, vertices_);
+  rtcAttachGeometry(scene, mesh);
+  rtcReleaseGeometry(mesh);
+  rtcCommitScene(scene);
+  return scene;
+}
+
+bool Primitive::hasSameShape(const Primitive & other) const
+{
+  const auto same_vertex = [](const Vertex & a, const Vertex & b) {
+    return a.x == b.x && a.y == b.y && a.z == b.z;
+  };
+  const auto same_triangle = [](const Triangle & a, const Triangle & b) {
+    return a.v0 == b.v0 && a.v1 == b.v1 && a.v2 == b.v2;
+  };
+  return type == other.type && vertices_.size() == other.vertices_.size() &&
+         triangles_.size() == other.triangles_.size() &&
+         std::equal(vertices_.begin(), vertices_.end(), other.vertices_.begin(), same_vertex) &&
+         std::equal(triangles_.begin(), triangles_.end(), other.triangles_.begin(), same_triangle);
+}
+
+std::array<float, 12> Primitive::getTransform() const
+{
+  const auto mat = quaternion_operation::getRotationMatrix(pose.orientation);
+  std::array<float, 12> ret;
+  for (size_t column = 0; column < 3; column++) {
+    for (size_t row = 0; row < 3; row++) {
+      ret[column * 3 + row] = mat(row, column);
+    }
+  }
+  ret[9] = pose.position.x;
+  ret[10] = pose.position.y;
+  ret[11] = pose.position.z;
+  return ret;
+}
 }  // namespace primitives
 }  // namespace simple_sensor_simulator
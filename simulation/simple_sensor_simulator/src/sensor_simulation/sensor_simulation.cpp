@@ -12,29 +12,153 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <algorithm>
+#include <cstddef>
 #include <memory>
 #include <simple_sensor_simulator/sensor_simulation/sensor_simulation.hpp>
 #include <string>
+#include <utility>
 #include <vector>
 
 namespace simple_sensor_simulator
 {
+SensorSimulation::SensorSimulation(std::size_t worker_threads)
+: thread_pool_(worker_threads), output_thread_([this]() { processFrames(); })
+{
+}
+
+SensorSimulation::~SensorSimulation()
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  condition_.notify_all();
+  output_thread_.join();
+}
+
 void SensorSimulation::updateSensorFrame(
   double current_time, const rclcpp::Time & current_ros_time,
   const std::vector<traffic_simulator_msgs::EntityStatus> & status)
 {
-  std::vector<std::string> detected_objects = {};
+  Frame frame;
+  frame.stamp = current_ros_time;
   for (auto & sensor : lidar_sensors_) {
-    sensor->update(current_time, status, current_ros_time);
-    const auto objects = sensor->getDetectedObjects();
-    for (const auto & obj : objects) {
+    frame.lidar_triggers.push_back(sensor->trigger(current_time));
+  }
+  for (auto & sensor : detection_sensors_) {
+    frame.detection_triggers.push_back(sensor->trigger(current_time));
+  }
+  const auto triggered = [](const auto & triggers) {
+    return std::find(triggers.begin(), triggers.end(), true) != triggers.end();
+  };
+  std::unique_lock<std::mutex> lock(mutex_);
+  condition_.wait(lock, [this]() { return frames_.size() < max_pending_frames || exception_; });
+  if (exception_) {
+    std::rethrow_exception(std::exchange(exception_, nullptr));
+  }
+  if (triggered(frame.lidar_triggers) || triggered(frame.detection_triggers)) {
+    frame.status = status;
+    frames_.push_back(std::move(frame));
+    lock.unlock();
+    condition_.notify_all();
+  }
+}
+
+auto SensorSimulation::waitForPendingFrames() -> void
+{
+  std::unique_lock<std::mutex> lock(mutex_);
+  condition_.wait(lock, [this]() { return frames_.empty(); });
+  if (exception_) {
+    std::rethrow_exception(std::exchange(exception_, nullptr));
+  }
+}
+
+auto SensorSimulation::processFrames() -> void
+{
+  while (true) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    condition_.wait(lock, [this]() { return stop_ || !frames_.empty(); });
+    if (frames_.empty()) {
+      return;
+    }
+    // References to the elements of a deque stay valid while other frames are pushed back.
+    const auto & frame = frames_.front();
+    lock.unlock();
+    std::exception_ptr exception = nullptr;
+    try {
+      updateSensors(frame);
+    } catch (...) {
+      exception = std::current_exception();
+    }
+    lock.lock();
+    if (exception && !exception_) {
+      exception_ = exception;
+    }
+    frames_.pop_front();
+    lock.unlock();
+    condition_.notify_all();
+  }
+}
+
+auto SensorSimulation::updateSensors(const Frame & frame) -> void
+{
+  const EntityIndex entity_index(frame.status);
+  // Each lidar sensor has its own raycaster, so the sensors are independent of each other.
+  thread_pool_.parallelFor(lidar_sensors_.size(), [&](std::size_t i) {
+    if (frame.lidar_triggers[i]) {
+      lidar_sensors_[i]->update(frame.status, entity_index, frame.stamp);
+    }
+  });
+  // Detection sensors report the entities hit by the latest scan of each lidar, whether or not the
+  // lidar scanned in this frame, since their update durations may differ.
+  std::vector<std::string> detected_objects = {};
+  for (const auto & sensor : lidar_sensors_) {
+    for (const auto & obj : sensor->getDetectedObjects()) {
       if (std::count(detected_objects.begin(), detected_objects.end(), obj) == 0) {
         detected_objects.push_back(obj);
       }
     }
   }
-  for (auto & sensor : detection_sensors_) {
-    sensor->update(current_time, status, current_ros_time, detected_objects);
+  const auto occlusion_triggered = [&]() {
+    for (std::size_t i = 0; i < detection_sensors_.size(); i++) {
+      if (frame.detection_triggers[i] && detection_sensors_[i]->isOcclusionMode()) {
+        return true;
+      }
+    }
+    return false;
+  };
+  if (occlusion_raycaster_ && occlusion_triggered()) {
+    DetectionSensorBase::updateOcclusionScene(*occlusion_raycaster_, frame.status, entity_index);
+  }
+  // The detection sensors only read the shared occlusion scene, so they are independent too.
+  thread_pool_.parallelFor(detection_sensors_.size(), [&](std::size_t i) {
+    if (frame.detection_triggers[i]) {
+      detection_sensors_[i]->update(
+        frame.status, entity_index, frame.stamp, detected_objects, occlusion_raycaster_.get());
+    }
+  });
+}
+
+auto SensorSimulation::logCullStatistics(const rclcpp::Logger & logger) -> void
+{
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    condition_.wait(lock, [this]() { return frames_.empty(); });
+  }
+  const auto log = [&](const auto & sensor_type, const auto & sensor) {
+    const auto & statistics = sensor->getCullStatistics();
+    RCLCPP_INFO_STREAM(
+      logger, sensor_type << " sensor of " << sensor->getEntityName() << " culled "
+                          << statistics.culled_by_range << " (range) + "
+                          << statistics.culled_by_fov << " (field of view) of "
+                          << statistics.entities << " entities");
+  };
+  for (const auto & sensor : lidar_sensors_) {
+    log("lidar", sensor);
+  }
+  for (const auto & sensor : detection_sensors_) {
+    log("detection", sensor);
   }
 }
 }  // namespace simple_sensor_simulator
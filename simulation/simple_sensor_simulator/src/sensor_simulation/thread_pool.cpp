@@ -0,0 +1,106 @@
+// Copyright 2015-2020 Tier IV, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <exception>
+#include <simple_sensor_simulator/sensor_simulation/thread_pool.hpp>
+#include <utility>
+
+namespace simple_sensor_simulator
+{
+ThreadPool::ThreadPool(std::size_t threads)
+{
+  if (threads == 0) {
+    threads = std::thread::hardware_concurrency();
+  }
+  for (std::size_t i = 1; i < threads; i++) {
+    workers_.emplace_back([this]() { work(); });
+  }
+}
+
+ThreadPool::~ThreadPool()
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  condition_.notify_all();
+  for (auto & worker : workers_) {
+    worker.join();
+  }
+}
+
+auto ThreadPool::work() -> void
+{
+  while (true) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    condition_.wait(lock, [this]() { return stop_ || !tasks_.empty(); });
+    if (tasks_.empty()) {
+      return;
+    }
+    auto task = std::move(tasks_.front());
+    tasks_.pop_front();
+    lock.unlock();
+    task();
+  }
+}
+
+auto ThreadPool::parallelFor(std::size_t n, const std::function<void(std::size_t)> & function)
+  -> void
+{
+  if (workers_.empty() || n <= 1) {
+    for (std::size_t i = 0; i < n; i++) {
+      function(i);
+    }
+    return;
+  }
+  std::size_t remaining = n;
+  std::exception_ptr exception = nullptr;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (std::size_t i = 0; i < n; i++) {
+      tasks_.emplace_back([this, &function, &remaining, &exception, i]() {
+        std::exception_ptr task_exception = nullptr;
+        try {
+          function(i);
+        } catch (...) {
+          task_exception = std::current_exception();
+        }
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (task_exception && !exception) {
+          exception = task_exception;
+        }
+        if (--remaining == 0) {
+          condition_.notify_all();
+        }
+      });
+    }
+  }
+  condition_.notify_all();
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (remaining != 0) {
+    if (tasks_.empty()) {
+      condition_.wait(lock);
+    } else {
+      auto task = std::move(tasks_.front());
+      tasks_.pop_front();
+      lock.unlock();
+      task();
+      lock.lock();
+    }
+  }
+  if (exception) {
+    std::rethrow_exception(exception);
+  }
+}
+}  // namespace simple_sensor_simulator
@@ -0,0 +1,292 @@
+// Copyright 2015-2020 Tier IV, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <quaternion_operation/quaternion_operation.h>
+#include <simulation_api_schema.pb.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <numeric>
+#include <random>
+#include <rclcpp/rclcpp.hpp>
+#include <simple_sensor_simulator/sensor_simulation/sensor_simulation.hpp>
+#include <simulation_interface/conversions.hpp>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+/**
+ * Drives SensorSimulation directly with synthetic entities to measure how the sensor path scales
+ * with the number of entities, lidar channels and horizontal resolution. Prints one JSON object
+ * per case to stdout.
+ *
+ *   ros2 run simple_sensor_simulator sensor_simulation_benchmark \
+ *     --entities 10,100,1000 --channels 16,32,128 --horizontal_resolution 0.2 --frames 50
+ *
+ * Angles are given in degrees. Every list option is swept over all combinations.
+ */
+
+namespace
+{
+std::atomic<std::size_t> allocations{0};
+}  // namespace
+
+void * operator new(std::size_t size)
+{
+  allocations++;
+  if (void * ptr = std::malloc(size == 0 ? 1 : size)) {
+    return ptr;
+  }
+  throw std::bad_alloc();
+}
+
+void operator delete(void * ptr) noexcept { std::free(ptr); }
+
+void operator delete(void * ptr, std::size_t) noexcept { std::free(ptr); }
+
+namespace
+{
+struct Options
+{
+  std::vector<std::size_t> entities = {10, 100, 1000};
+
+  std::vector<std::size_t> channels = {16, 32, 128};
+
+  std::vector<double> horizontal_resolutions = {0.4, 0.2, 0.1};
+
+  std::size_t frames = 50;
+
+  std::size_t warmup_frames = 5;
+
+  std::size_t threads = 0;
+
+  // Entities are scattered uniformly over a square of this size centered on the ego.
+  double area = 200;
+
+  double step_time = 0.1;
+};
+
+template <typename T>
+auto parseList(const std::string & value) -> std::vector<T>
+{
+  std::vector<T> ret;
+  std::stringstream ss(value);
+  std::string item;
+  while (std::getline(ss, item, ',')) {
+    ret.emplace_back(static_cast<T>(std::stod(item)));
+  }
+  return ret;
+}
+
+auto parseOptions(const std::vector<std::string> & arguments) -> Options
+{
+  Options options;
+  for (std::size_t i = 1; i + 1 < arguments.size(); i += 2) {
+    const auto & key = arguments[i];
+    const auto & value = arguments[i + 1];
+    if (key == "--entities") {
+      options.entities = parseList<std::size_t>(value);
+    } else if (key == "--channels") {
+      options.channels = parseList<std::size_t>(value);
+    } else if (key == "--horizontal_resolution") {
+      options.horizontal_resolutions = parseList<double>(value);
+    } else if (key == "--frames") {
+      options.frames = std::stoul(value);
+      if (options.frames == 0) {
+        throw std::invalid_argument("--frames must be greater than 0");
+      }
+    } else if (key == "--warmup_frames") {
+      options.warmup_frames = std::stoul(value);
+    } else if (key == "--threads") {
+      options.threads = std::stoul(value);
+    } else if (key == "--area") {
+      options.area = std::stod(value);
+    } else {
+      throw std::invalid_argument("unknown option " + key);
+    }
+  }
+  return options;
+}
+
+auto makeEntityStatus(
+  const std::string & name, traffic_simulator_msgs::EntityType type, double x, double y,
+  double yaw, double length, double width, double height) -> traffic_simulator_msgs::EntityStatus
+{
+  traffic_simulator_msgs::EntityStatus status;
+  status.set_name(name);
+  status.set_type(type);
+  geometry_msgs::msg::Pose pose;
+  pose.position.x = x;
+  pose.position.y = y;
+  geometry_msgs::msg::Vector3 rpy;
+  rpy.z = yaw;
+  pose.orientation = quaternion_operation::convertEulerAngleToQuaternion(rpy);
+  simulation_interface::toProto(pose, *status.mutable_pose());
+  status.mutable_bounding_box()->mutable_center()->set_z(0.5 * height);
+  status.mutable_bounding_box()->mutable_dimensions()->set_x(length);
+  status.mutable_bounding_box()->mutable_dimensions()->set_y(width);
+  status.mutable_bounding_box()->mutable_dimensions()->set_z(height);
+  return status;
+}
+
+auto makeEntities(std::size_t count, double area, std::mt19937 & engine)
+  -> std::vector<traffic_simulator_msgs::EntityStatus>
+{
+  std::uniform_real_distribution<double> position(-0.5 * area, 0.5 * area);
+  std::uniform_real_distribution<double> yaw(-M_PI, M_PI);
+  std::vector<traffic_simulator_msgs::EntityStatus> ret = {
+    makeEntityStatus("ego", traffic_simulator_msgs::EntityType::EGO, 0, 0, 0, 4.5, 2.0, 1.5)};
+  for (std::size_t i = 0; i < count; i++) {
+    if (i % 4 == 3) {
+      ret.emplace_back(makeEntityStatus(
+        "pedestrian" + std::to_string(i), traffic_simulator_msgs::EntityType::PEDESTRIAN,
+        position(engine), position(engine), yaw(engine), 0.5, 0.5, 1.8));
+    } else {
+      ret.emplace_back(makeEntityStatus(
+        "vehicle" + std::to_string(i), traffic_simulator_msgs::EntityType::VEHICLE,
+        position(engine), position(engine), yaw(engine), 4.5, 1.8, 1.5));
+    }
+  }
+  return ret;
+}
+
+/**
+ * @brief Move every entity forward along its heading, so that the scene changes every frame.
+ */
+auto moveEntities(std::vector<traffic_simulator_msgs::EntityStatus> & status, double distance)
+  -> void
+{
+  for (auto & s : status) {
+    geometry_msgs::msg::Pose pose;
+    simulation_interface::toMsg(s.pose(), pose);
+    const auto yaw = quaternion_operation::convertQuaternionToEulerAngle(pose.orientation).z;
+    s.mutable_pose()->mutable_position()->set_x(pose.position.x + distance * std::cos(yaw));
+    s.mutable_pose()->mutable_position()->set_y(pose.position.y + distance * std::sin(yaw));
+  }
+}
+
+auto makeLidarConfiguration(std::size_t channels, double horizontal_resolution, double step_time)
+  -> simulation_api_schema::LidarConfiguration
+{
+  simulation_api_schema::LidarConfiguration configuration;
+  configuration.set_entity("ego");
+  configuration.set_architecture_type("awf/universe");
+  configuration.set_horizontal_resolution(horizontal_resolution / 180.0 * M_PI);
+  configuration.set_scan_duration(step_time);
+  for (std::size_t i = 0; i < channels; i++) {
+    const auto angle = channels == 1 ? 0.0 : -15.0 + 30.0 * i / (channels - 1);
+    configuration.add_vertical_angles(angle / 180.0 * M_PI);
+  }
+  return configuration;
+}
+
+auto makeDetectionSensorConfiguration(double step_time)
+  -> simulation_api_schema::DetectionSensorConfiguration
+{
+  simulation_api_schema::DetectionSensorConfiguration configuration;
+  configuration.set_entity("ego");
+  configuration.set_architecture_type("awf/universe");
+  configuration.set_update_duration(step_time);
+  return configuration;
+}
+
+/**
+ * @brief Number of rays of a scan, counted the same way as Raycaster::setDirections does.
+ */
+auto countRays(const simulation_api_schema::LidarConfiguration & configuration) -> std::size_t
+{
+  std::size_t horizontal_count = 0;
+  for (double angle = 0; angle <= 2 * M_PI; angle += configuration.horizontal_resolution()) {
+    horizontal_count++;
+  }
+  return horizontal_count * configuration.vertical_angles_size();
+}
+
+auto percentile(std::vector<double> values, double p) -> double
+{
+  std::sort(values.begin(), values.end());
+  return values.empty() ? 0 : values[std::min<std::size_t>(p * values.size(), values.size() - 1)];
+}
+
+auto benchmark(
+  rclcpp::Node & node, const Options & options, std::size_t entity_count, std::size_t channels,
+  double horizontal_resolution) -> std::string
+{
+  simple_sensor_simulator::SensorSimulation sensor_simulation(options.threads);
+  const auto lidar_configuration =
+    makeLidarConfiguration(channels, horizontal_resolution, options.step_time);
+  sensor_simulation.attachLidarSensor(0, lidar_configuration, node);
+  sensor_simulation.attachDetectionSensor(
+    0, makeDetectionSensorConfiguration(options.step_time), node);
+
+  std::mt19937 engine(0);
+  auto status = makeEntities(entity_count, options.area, engine);
+  std::vector<double> latencies;
+  std::vector<double> frame_allocations;
+  for (std::size_t frame = 0; frame < options.warmup_frames + options.frames; frame++) {
+    const double current_time = (frame + 1) * options.step_time;
+    const rclcpp::Time stamp(static_cast<int64_t>(current_time * 1e9));
+    moveEntities(status, options.step_time);
+    const auto allocations_before = allocations.load();
+    const auto begin = std::chrono::steady_clock::now();
+    sensor_simulation.updateSensorFrame(current_time, stamp, status);
+    sensor_simulation.waitForPendingFrames();
+    const auto end = std::chrono::steady_clock::now();
+    if (options.warmup_frames <= frame) {
+      latencies.emplace_back(std::chrono::duration<double, std::milli>(end - begin).count());
+      frame_allocations.emplace_back(allocations.load() - allocations_before);
+    }
+  }
+
+  const auto rays = countRays(lidar_configuration);
+  const auto total_latency = std::accumulate(latencies.begin(), latencies.end(), 0.0);
+  std::stringstream ss;
+  ss << "{\"entities\": " << entity_count << ", \"channels\": " << channels
+     << ", \"horizontal_resolution\": " << horizontal_resolution << ", \"rays\": " << rays
+     << ", \"threads\": " << options.threads << ", \"frames\": " << latencies.size()
+     << ", \"latency_ms\": {\"mean\": " << total_latency / latencies.size()
+     << ", \"p50\": " << percentile(latencies, 0.5) << ", \"p99\": " << percentile(latencies, 0.99)
+     << ", \"max\": " << percentile(latencies, 1.0) << "}"
+     << ", \"rays_per_second\": " << rays * latencies.size() / (total_latency / 1000)
+     << ", \"allocations_per_frame\": "
+     << std::accumulate(frame_allocations.begin(), frame_allocations.end(), 0.0) /
+          frame_allocations.size()
+     << "}";
+  return ss.str();
+}
+}  // namespace
+
+int main(int argc, char * argv[])
+{
+  rclcpp::init(argc, argv);
+  const auto options = parseOptions(rclcpp::remove_ros_arguments(argc, argv));
+  auto node = std::make_shared<rclcpp::Node>("sensor_simulation_benchmark");
+  for (const auto entities : options.entities) {
+    for (const auto channels : options.channels) {
+      for (const auto horizontal_resolution : options.horizontal_resolutions) {
+        std::cout << benchmark(*node, options, entities, channels, horizontal_resolution)
+                  << std::endl;
+      }
+    }
+  }
+  rclcpp::shutdown();
+  return 0;
+}
@@ -14,6 +14,7 @@
 
 #include <quaternion_operation/quaternion_operation.h>
 
+#include <algorithm>
 #include <geometry_msgs/msg/pose_stamped.hpp>
 #include <limits>
 #include <memory>
@@ -30,7 +31,7 @@ namespace simple_sensor_simulator
 {
 ScenarioSimulator::ScenarioSimulator(const rclcpp::NodeOptions & options)
 : Node("simple_sensor_simulator", options),
-  sensor_sim_(),
+  sensor_sim_(std::max<int64_t>(declare_parameter<int64_t>("sensor_worker_threads", 0), 0)),
   server_(
     simulation_interface::protocol, simulation_interface::HostName::ANY,
     std::bind(&ScenarioSimulator::initialize, this, std::placeholders::_1, std::placeholders::_2),
@@ -59,7 +60,7 @@ ScenarioSimulator::ScenarioSimulator(const rclcpp::NodeOptions & options)
 {
 }
 
-ScenarioSimulator::~ScenarioSimulator() {}
+ScenarioSimulator::~ScenarioSimulator() { sensor_sim_.logCullStatistics(get_logger()); }
 
 void ScenarioSimulator::initialize(
   const simulation_api_schema::InitializeRequest & req,
@@ -68,6 +69,7 @@ void ScenarioSimulator::initialize(
   initialized_ = true;
   realtime_factor_ = req.realtime_factor();
   step_time_ = req.step_time();
+  sensor_sim_.loadLaneletMap(req.lanelet2_map_path());
   res = simulation_api_schema::InitializeResponse();
   res.mutable_result()->set_success(true);
   res.mutable_result()->set_description("succeed to initialize simulation");
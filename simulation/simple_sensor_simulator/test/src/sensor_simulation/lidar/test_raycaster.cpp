@@ -0,0 +1,141 @@
+// Copyright 2015-2020 Tier IV, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <future>
+#include <memory>
+#include <simple_sensor_simulator/sensor_simulation/lidar/raycaster.hpp>
+#include <string>
+#include <vector>
+
+auto makePose(const double x, const double y, const double z) -> geometry_msgs::msg::Pose
+{
+  geometry_msgs::msg::Pose pose;
+  pose.position.x = x;
+  pose.position.y = y;
+  pose.position.z = z;
+  return pose;
+}
+
+auto makeVerticalAngles() -> std::vector<double>
+{
+  std::vector<double> vertical_angles;
+  for (int i = 0; i < 16; i++) {
+    vertical_angles.push_back((-15.0 + 2.0 * i) / 180.0 * M_PI);
+  }
+  return vertical_angles;
+}
+
+/**
+ * @brief A few boxes around the origin, some hidden behind others.
+ */
+void addScene(simple_sensor_simulator::Raycaster & raycaster)
+{
+  using simple_sensor_simulator::primitives::Box;
+  raycaster.addPrimitive<Box>("front", 4.0, 2.0, 1.5, makePose(10, 0, 0));
+  raycaster.addPrimitive<Box>("behind_front", 4.0, 2.0, 1.5, makePose(20, 0, 0));
+  raycaster.addPrimitive<Box>("left", 1.0, 1.0, 2.0, makePose(0, 5, 0));
+  raycaster.addPrimitive<Box>("rear", 5.0, 2.5, 3.0, makePose(-30, 3, 1));
+  raycaster.addPrimitive<Box>("far", 4.0, 2.0, 1.5, makePose(150, 0, 0));
+}
+
+auto raycast(simple_sensor_simulator::Raycaster & raycaster) -> sensor_msgs::msg::PointCloud2
+{
+  raycaster.setDirections(0.2 / 180.0 * M_PI, makeVerticalAngles());
+  addScene(raycaster);
+  sensor_msgs::msg::PointCloud2 pointcloud;
+  raycaster.raycast("base_link", rclcpp::Time(), makePose(0, 0, 1), pointcloud);
+  return pointcloud;
+}
+
+TEST(RAYCASTER, RAY_PACKET_SIZE)
+{
+  simple_sensor_simulator::Raycaster reference;
+  reference.setRayPacketSize(1);
+  const auto expected = raycast(reference);
+  ASSERT_GT(expected.width, static_cast<uint32_t>(0));
+  EXPECT_FALSE(reference.getDetectedObject().empty());
+  for (const size_t ray_packet_size : {4, 8, 16}) {
+    simple_sensor_simulator::Raycaster raycaster;
+    raycaster.setRayPacketSize(ray_packet_size);
+    const auto actual = raycast(raycaster);
+    EXPECT_EQ(actual.width, expected.width) << "ray packet size : " << ray_packet_size;
+    EXPECT_EQ(actual.data, expected.data) << "ray packet size : " << ray_packet_size;
+    EXPECT_EQ(raycaster.getDetectedObject(), reference.getDetectedObject())
+      << "ray packet size : " << ray_packet_size;
+  }
+}
+
+TEST(RAYCASTER, INVALID_RAY_PACKET_SIZE)
+{
+  simple_sensor_simulator::Raycaster raycaster;
+  EXPECT_THROW(raycaster.setRayPacketSize(2), std::runtime_error);
+  EXPECT_THROW(raycaster.setRayPacketSize(0), std::runtime_error);
+}
+
+TEST(RAYCASTER, THREAD_POOL)
+{
+  simple_sensor_simulator::ThreadPool single_thread(1);
+  simple_sensor_simulator::Raycaster reference;
+  reference.setThreadPool(&single_thread);
+  const auto expected = raycast(reference);
+  ASSERT_GT(expected.width, static_cast<uint32_t>(0));
+  simple_sensor_simulator::ThreadPool thread_pool(8);
+  simple_sensor_simulator::Raycaster raycaster;
+  raycaster.setThreadPool(&thread_pool);
+  const auto actual = raycast(raycaster);
+  EXPECT_EQ(actual.width, expected.width);
+  EXPECT_EQ(actual.data, expected.data);
+  EXPECT_EQ(raycaster.getDetectedObject(), reference.getDetectedObject());
+}
+
+TEST(RAYCASTER, SHARED_STATIC_PRIMITIVE)
+{
+  const auto device = std::make_shared<simple_sensor_simulator::RaycastDevice>();
+  device->setStaticPrimitive(
+    simple_sensor_simulator::primitives::Box(4.0, 2.0, 1.5, makePose(10, 0, 0)));
+  for (int i = 0; i < 2; i++) {
+    simple_sensor_simulator::Raycaster raycaster(device);
+    raycaster.setDirections(0.2 / 180.0 * M_PI, makeVerticalAngles());
+    sensor_msgs::msg::PointCloud2 pointcloud;
+    raycaster.raycast("base_link", rclcpp::Time(), makePose(0, 0, 1), pointcloud);
+    EXPECT_GT(pointcloud.width, static_cast<uint32_t>(0)) << "raycaster : " << i;
+    EXPECT_TRUE(raycaster.getDetectedObject().empty()) << "raycaster : " << i;
+  }
+}
+
+TEST(RAYCASTER, VISIBLE_PRIMITIVES)
+{
+  simple_sensor_simulator::Raycaster raycaster;
+  addScene(raycaster);
+  raycaster.addPrimitive<simple_sensor_simulator::primitives::Box>(
+    "ego", 4.0, 2.0, 1.5, makePose(0, 0, 0));
+  raycaster.commitScene();
+  // The rays start inside the excluded ego, and the two threads query the scene at once.
+  const auto query = [&raycaster]() {
+    return raycaster.getVisiblePrimitives(
+      makePose(0, 0, 0).position, {"front", "behind_front", "left"}, 16, "ego");
+  };
+  auto other_thread = std::async(std::launch::async, query);
+  EXPECT_EQ(query(), (std::vector<std::string>{"front", "left"}));
+  EXPECT_EQ(other_thread.get(), (std::vector<std::string>{"front", "left"}));
+}
+
+int main(int argc, char ** argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
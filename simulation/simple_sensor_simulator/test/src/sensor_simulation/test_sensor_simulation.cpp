@@ -0,0 +1,99 @@
+// Copyright 2015-2020 Tier IV, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <autoware_auto_perception_msgs/msg/predicted_objects.hpp>
+#include <chrono>
+#include <cmath>
+#include <memory>
+#include <rclcpp/rclcpp.hpp>
+#include <simple_sensor_simulator/sensor_simulation/sensor_simulation.hpp>
+#include <simulation_interface/conversions.hpp>
+#include <string>
+#include <vector>
+
+auto makeEntityStatus(
+  const std::string & name, traffic_simulator_msgs::EntityType type, double x)
+  -> traffic_simulator_msgs::EntityStatus
+{
+  traffic_simulator_msgs::EntityStatus status;
+  status.set_name(name);
+  status.set_type(type);
+  geometry_msgs::msg::Pose pose;
+  pose.position.x = x;
+  simulation_interface::toProto(pose, *status.mutable_pose());
+  status.mutable_bounding_box()->mutable_center()->set_z(0.75);
+  status.mutable_bounding_box()->mutable_dimensions()->set_x(4.0);
+  status.mutable_bounding_box()->mutable_dimensions()->set_y(2.0);
+  status.mutable_bounding_box()->mutable_dimensions()->set_z(1.5);
+  return status;
+}
+
+/**
+ * @brief The lidar scans every 0.1 s and the detection sensor updates every 0.05 s, so only
+ * every other detection update has a lidar scan in the same frame.
+ */
+TEST(SENSOR_SIMULATION, DETECTION_BETWEEN_LIDAR_SCANS)
+{
+  using autoware_auto_perception_msgs::msg::PredictedObjects;
+  const auto node = std::make_shared<rclcpp::Node>("detection_between_lidar_scans");
+  std::vector<PredictedObjects> messages;
+  const auto subscription = node->create_subscription<PredictedObjects>(
+    "/perception/object_recognition/objects", 10,
+    [&messages](const PredictedObjects::SharedPtr message) { messages.push_back(*message); });
+
+  simple_sensor_simulator::SensorSimulation sensor_simulation;
+  simulation_api_schema::LidarConfiguration lidar_configuration;
+  lidar_configuration.set_entity("ego");
+  lidar_configuration.set_architecture_type("awf/universe");
+  lidar_configuration.set_horizontal_resolution(1.0 / 180.0 * M_PI);
+  lidar_configuration.add_vertical_angles(0);
+  lidar_configuration.set_scan_duration(0.1);
+  lidar_configuration.set_mounting_height(1.0);
+  sensor_simulation.attachLidarSensor(0, lidar_configuration, *node);
+  simulation_api_schema::DetectionSensorConfiguration detection_configuration;
+  detection_configuration.set_entity("ego");
+  detection_configuration.set_architecture_type("awf/universe");
+  detection_configuration.set_update_duration(0.05);
+  sensor_simulation.attachDetectionSensor(0, detection_configuration, *node);
+
+  const std::vector<traffic_simulator_msgs::EntityStatus> status = {
+    makeEntityStatus("ego", traffic_simulator_msgs::EntityType::EGO, 0),
+    makeEntityStatus("npc", traffic_simulator_msgs::EntityType::VEHICLE, 10)};
+  const auto update = [&](double current_time) {
+    const auto count = messages.size();
+    sensor_simulation.updateSensorFrame(current_time, rclcpp::Time(), status);
+    sensor_simulation.waitForPendingFrames();
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(1);
+    while (messages.size() == count && std::chrono::steady_clock::now() < deadline) {
+      rclcpp::spin_some(node);
+    }
+    return messages.size() == count ? -1 : static_cast<int>(messages.back().objects.size());
+  };
+  // The lidar has not scanned yet.
+  EXPECT_EQ(update(0.05), 0);
+  // Both sensors are due.
+  EXPECT_EQ(update(0.10), 1);
+  // Only the detection sensor is due, and it reports the hits of the previous lidar scan.
+  EXPECT_EQ(update(0.15), 1);
+  EXPECT_EQ(update(0.20), 1);
+}
+
+int main(int argc, char ** argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  rclcpp::init(argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -20,6 +20,7 @@
 #include <boost/filesystem.hpp>
 #include <boost/filesystem/operations.hpp>
 #include <boost/range/iterator_range.hpp>
+#include <cstddef>
 #include <iomanip>
 #include <scenario_simulator_exception/exception.hpp>
 #include <string>
@@ -40,6 +41,31 @@ struct Configuration
 
   double initialize_duration = 0;
 
+  // Publish rate of the "entity/status" debug topic in simulation time. 0 means every frame.
+  double entity_status_publish_rate = 0;
+
+  // Omit waypoints, goal poses and obstacles of "entity/status" if they are unchanged.
+  bool compact_entity_status = false;
+
+  // Level of detail of NPCs. Disabled if lod_full_radius is 0.
+  // Entities farther than lod_full_radius from the ego evaluate their behavior every
+  // lod_reduced_interval frames, and entities farther than lod_reduced_radius only follow their
+  // lanes kinematically.
+  double lod_full_radius = 0;
+
+  double lod_reduced_radius = 0;
+
+  std::size_t lod_reduced_interval = 4;
+
+  // Measure the tick time of each behavior tree node. The result is a part of the update cost
+  // report.
+  bool profile_behavior_trees = false;
+
+  // Let the lidar sensors of the sensor simulator see the road surfaces, curbs and walls of the
+  // lanelet map in addition to the entities. Set LidarConfiguration.mounting_height as well, or the
+  // rays start on the road surface.
+  bool lidar_map_geometry = false;
+
   /* ---- NOTE -----------------------------------------------------------------
    *
    *  This setting comes from the argument of the same name (= `map_path`) in
@@ -63,6 +89,10 @@ struct Configuration
 
   Pathname metrics_log_path = "/tmp/metrics.json";
 
+  // Per-entity and per-behavior-plugin update time histograms are written here at the end of the
+  // scenario. Nothing is written if empty.
+  Pathname update_cost_log_path = "";
+
   Pathname rviz_config_path =  //
     ament_index_cpp::get_package_share_directory("traffic_simulator") +
     "/config/scenario_simulator_v2.rviz";
@@ -16,7 +16,9 @@
 #define TRAFFIC_SIMULATOR__BEHAVIOR__BEHAVIOR_PLUGIN_BASE_HPP_
 
 #include <boost/optional.hpp>
+#include <memory>
 #include <string>
+#include <traffic_simulator/behavior/lanelet_entity_index.hpp>
 #include <traffic_simulator/data_type/data_types.hpp>
 #include <traffic_simulator/hdmap_utils/hdmap_utils.hpp>
 #include <traffic_simulator/traffic_lights/traffic_light_manager.hpp>
@@ -28,6 +30,7 @@
 #include <traffic_simulator_msgs/msg/vehicle_parameters.hpp>
 #include <traffic_simulator_msgs/msg/waypoints_array.hpp>
 #include <unordered_map>
+#include <vector>
 #include <visualization_msgs/msg/marker_array.hpp>
 
 namespace entity_behavior
@@ -44,6 +47,45 @@ public:
   typedef std::unordered_map<std::string, traffic_simulator_msgs::msg::EntityStatus>
     EntityStatusDict;
 
+  /**
+   * @brief Entities only react to the other entities closer than this.
+   */
+  static constexpr double other_entity_range = 30;
+
+  /**
+   * @brief State of the whole simulation at the beginning of the frame, shared by all entities.
+   */
+  struct WorldSnapshot
+  {
+    double current_time;
+
+    double step_time;
+
+    std::shared_ptr<const EntityStatusDict> entity_status;
+
+    std::shared_ptr<const EntityTypeDict> entity_type_list;
+
+    std::shared_ptr<const LaneletEntityIndex> lanelet_entity_index;
+  };
+
+  /**
+   * @brief Returns true if the plugin overrides updateBatch to update many entities at once.
+   */
+  virtual bool supportsBatchUpdate() const { return false; }
+
+  /**
+   * @brief Updates all the given plugin instances in one call.
+   * @note Every instance in plugins is of the same plugin type as this, including this itself,
+   * and its inputs are already set as they would be for update(current_time, step_time).
+   */
+  virtual void updateBatch(
+    const std::vector<BehaviorPluginBase *> & plugins, const WorldSnapshot & world)
+  {
+    for (const auto plugin : plugins) {
+      plugin->update(world.current_time, world.step_time);
+    }
+  }
+
 #define DEFINE_GETTER_SETTER(NAME, KEY, TYPE)     \
   virtual TYPE get##NAME() = 0;                   \
   virtual void set##NAME(const TYPE & value) = 0; \
@@ -54,11 +96,12 @@ public:
   DEFINE_GETTER_SETTER(DebugMarker, "debug_marker", std::vector<visualization_msgs::msg::Marker>)
   DEFINE_GETTER_SETTER(DriverModel, "driver_model", traffic_simulator_msgs::msg::DriverModel)
   DEFINE_GETTER_SETTER(EntityStatus, "entity_status", traffic_simulator_msgs::msg::EntityStatus)
-  DEFINE_GETTER_SETTER(EntityTypeList, "entity_type_list", EntityTypeDict)
+  DEFINE_GETTER_SETTER(EntityTypeList, "entity_type_list", std::shared_ptr<const EntityTypeDict>)
   DEFINE_GETTER_SETTER(GoalPoses, "goal_poses", std::vector<geometry_msgs::msg::Pose>)
   DEFINE_GETTER_SETTER(HdMapUtils, "hdmap_utils", std::shared_ptr<hdmap_utils::HdMapUtils>)
+  DEFINE_GETTER_SETTER(LaneletEntityIndex, "lanelet_entity_index", std::shared_ptr<const LaneletEntityIndex>)
   DEFINE_GETTER_SETTER(Obstacle, "obstacle", boost::optional<traffic_simulator_msgs::msg::Obstacle>)
-  DEFINE_GETTER_SETTER(OtherEntityStatus, "other_entity_status", EntityStatusDict)
+  DEFINE_GETTER_SETTER(OtherEntityStatus, "other_entity_status", std::shared_ptr<const EntityStatusDict>)
   DEFINE_GETTER_SETTER(PedestrianParameters, "pedestrian_parameters", traffic_simulator_msgs::msg::PedestrianParameters)
   DEFINE_GETTER_SETTER(Request, "request", std::string)
   DEFINE_GETTER_SETTER(RouteLanelets, "route_lanelets", std::vector<std::int64_t>)
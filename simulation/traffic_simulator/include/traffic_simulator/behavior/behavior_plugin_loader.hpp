@@ -0,0 +1,55 @@
+// Copyright 2015-2020 Tier IV, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef TRAFFIC_SIMULATOR__BEHAVIOR__BEHAVIOR_PLUGIN_LOADER_HPP_
+#define TRAFFIC_SIMULATOR__BEHAVIOR__BEHAVIOR_PLUGIN_LOADER_HPP_
+
+#include <memory>
+#include <mutex>
+#include <pluginlib/class_loader.hpp>
+#include <string>
+#include <traffic_simulator/behavior/behavior_plugin_base.hpp>
+#include <unordered_set>
+
+namespace entity_behavior
+{
+/**
+ * @brief Process-wide registry of behavior plugins.
+ * @note The plugin manifests are parsed once, and the library of each plugin class is loaded the
+ * first time it is requested and kept loaded until the end of the process.
+ */
+class BehaviorPluginLoader
+{
+public:
+  static auto get() -> BehaviorPluginLoader &;
+
+  auto createSharedInstance(const std::string & plugin_name)
+    -> std::shared_ptr<BehaviorPluginBase>;
+
+  BehaviorPluginLoader(const BehaviorPluginLoader &) = delete;
+
+  auto operator=(const BehaviorPluginLoader &) -> BehaviorPluginLoader & = delete;
+
+private:
+  BehaviorPluginLoader();
+
+  std::shared_ptr<pluginlib::ClassLoader<BehaviorPluginBase>> loader_;
+
+  std::unordered_set<std::string> loaded_plugin_names_;
+
+  std::mutex mutex_;
+};
+}  // namespace entity_behavior
+
+#endif  // TRAFFIC_SIMULATOR__BEHAVIOR__BEHAVIOR_PLUGIN_LOADER_HPP_
@@ -0,0 +1,77 @@
+// Copyright 2015-2020 Tier IV, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef TRAFFIC_SIMULATOR__BEHAVIOR__BEHAVIOR_TREE_PROFILER_HPP_
+#define TRAFFIC_SIMULATOR__BEHAVIOR__BEHAVIOR_TREE_PROFILER_HPP_
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <map>
+#include <mutex>
+#include <nlohmann/json.hpp>
+#include <string>
+#include <traffic_simulator/helper/histogram.hpp>
+
+namespace entity_behavior
+{
+/**
+ * @brief Process-wide tick time and tick count of behavior tree nodes, aggregated per behavior.
+ * @note Disabled by default. Behavior plugins check enabled() before measuring anything.
+ * EntityManager enables it according to Configuration::profile_behavior_trees, and disables and
+ * clears it when destroyed.
+ */
+class BehaviorTreeProfiler
+{
+public:
+  static auto get() -> BehaviorTreeProfiler &;
+
+  void enable(const bool enabled = true) noexcept { enabled_ = enabled; }
+
+  auto enabled() const noexcept -> bool { return enabled_; }
+
+  void addTick(
+    const std::string & behavior, const std::string & node,
+    const std::chrono::nanoseconds & duration);
+
+  /**
+   * @brief Records how many times the tree was ticked within one update of the behavior.
+   */
+  void addUpdate(const std::string & behavior, const std::size_t ticks);
+
+  void clear();
+
+  auto toJson() const -> nlohmann::json;
+
+private:
+  struct Profile
+  {
+    std::size_t updates = 0;
+
+    std::size_t ticks = 0;
+
+    std::size_t max_ticks_per_update = 0;
+
+    std::map<std::string, traffic_simulator::helper::Histogram> nodes;
+  };
+
+  std::atomic<bool> enabled_{false};
+
+  mutable std::mutex mutex_;
+
+  std::map<std::string, Profile> profiles_;
+};
+}  // namespace entity_behavior
+
+#endif  // TRAFFIC_SIMULATOR__BEHAVIOR__BEHAVIOR_TREE_PROFILER_HPP_
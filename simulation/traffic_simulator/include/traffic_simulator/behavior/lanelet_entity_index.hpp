@@ -0,0 +1,89 @@
+// Copyright 2015-2020 Tier IV, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef TRAFFIC_SIMULATOR__BEHAVIOR__LANELET_ENTITY_INDEX_HPP_
+#define TRAFFIC_SIMULATOR__BEHAVIOR__LANELET_ENTITY_INDEX_HPP_
+
+#include <cstdint>
+#include <geometry_msgs/msg/point.hpp>
+#include <memory>
+#include <string>
+#include <traffic_simulator_msgs/msg/entity_status.hpp>
+#include <unordered_map>
+#include <vector>
+
+namespace entity_behavior
+{
+/**
+ * @brief Index from lanelet id and from position to the entities, built once per frame from the
+ * statuses of all entities and shared by every entity and behavior plugin.
+ */
+class LaneletEntityIndex
+{
+public:
+  typedef std::unordered_map<std::string, traffic_simulator_msgs::msg::EntityStatus>
+    EntityStatusDict;
+
+  explicit LaneletEntityIndex(
+    const std::shared_ptr<const EntityStatusDict> & entity_status, double cell_size = 30);
+
+  /**
+   * @brief Entities on the lanelet. Entities whose lanelet pose is not valid are on no lanelet.
+   */
+  auto getEntityStatus(std::int64_t lanelet_id) const
+    -> const std::vector<const traffic_simulator_msgs::msg::EntityStatus *> &;
+
+  /**
+   * @brief Entities whose position is closer than radius to the given position, in no particular
+   * order.
+   */
+  auto getEntityStatus(const geometry_msgs::msg::Point & position, double radius) const
+    -> std::vector<const traffic_simulator_msgs::msg::EntityStatus *>;
+
+  auto empty(std::int64_t lanelet_id) const -> bool;
+
+  /**
+   * @brief Largest distance from the position of an entity to a corner of its bounding box.
+   */
+  auto getMaxBoundingRadius() const -> double { return max_bounding_radius_; }
+
+  /**
+   * @brief Statuses of all entities the index was built from.
+   */
+  auto getEntityStatusDict() const -> const std::shared_ptr<const EntityStatusDict> &
+  {
+    return entity_status_;
+  }
+
+private:
+  auto getCellIndex(double value) const -> std::int64_t;
+
+  static auto getCellKey(std::int64_t column, std::int64_t row) -> std::int64_t;
+
+  const std::shared_ptr<const EntityStatusDict> entity_status_;
+
+  const double cell_size_;
+
+  double max_bounding_radius_ = 0;
+
+  std::unordered_map<std::int64_t, std::vector<const traffic_simulator_msgs::msg::EntityStatus *>>
+    entities_;
+
+  // Uniform grid over the positions of the entities, keyed by getCellKey.
+  std::unordered_map<std::int64_t, std::vector<const traffic_simulator_msgs::msg::EntityStatus *>>
+    cells_;
+};
+}  // namespace entity_behavior
+
+#endif  // TRAFFIC_SIMULATOR__BEHAVIOR__LANELET_ENTITY_INDEX_HPP_
@@ -104,6 +104,11 @@ public:
 
   void onUpdate(double current_time, double step_time) override;
 
+  void onKinematicUpdate(double current_time, double step_time) override
+  {
+    onUpdate(current_time, step_time);
+  }
+
   auto ready() const -> bool override;
 
   void requestAcquirePosition(const traffic_simulator_msgs::msg::LaneletPose &) override;
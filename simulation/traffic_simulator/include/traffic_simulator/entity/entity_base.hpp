@@ -21,8 +21,10 @@
 #include <memory>
 #include <queue>
 #include <string>
+#include <traffic_simulator/behavior/behavior_plugin_base.hpp>
 #include <traffic_simulator/data_type/data_types.hpp>
 #include <traffic_simulator/hdmap_utils/hdmap_utils.hpp>
+#include <traffic_simulator/math/catmull_rom_spline.hpp>
 #include <traffic_simulator/traffic_lights/traffic_light_manager.hpp>
 #include <traffic_simulator_msgs/msg/bounding_box.hpp>
 #include <traffic_simulator_msgs/msg/driver_model.hpp>
@@ -32,6 +34,7 @@
 #include <traffic_simulator_msgs/msg/vehicle_parameters.hpp>
 #include <traffic_simulator_msgs/msg/waypoints_array.hpp>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 #include <visualization_msgs/msg/marker_array.hpp>
 
@@ -55,6 +58,8 @@ public:
 
   virtual void engage() {}
 
+  virtual auto getBehaviorPluginName() const -> const std::string & { return getEntityTypename(); }
+
   virtual auto getBoundingBox() const -> const traffic_simulator_msgs::msg::BoundingBox = 0;
 
   virtual auto getCurrentAction() const -> const std::string = 0;
@@ -93,6 +98,12 @@ public:
 
   virtual auto getWaypoints() -> const traffic_simulator_msgs::msg::WaypointsArray = 0;
 
+  /**
+   * @brief Spline of the waypoints, built at most once per frame.
+   * @return nullptr if the entity has no waypoints.
+   */
+  /*   */ auto getWaypointsSpline() -> std::shared_ptr<const math::CatmullRomSpline>;
+
   virtual auto getGoalPoses() -> std::vector<traffic_simulator_msgs::msg::LaneletPose> = 0;
 
   virtual auto getDriverModel() const -> traffic_simulator_msgs::msg::DriverModel = 0;
@@ -104,7 +115,7 @@ public:
   virtual void setDecelerationLimit(double deceleration);
 
   /*   */ void setEntityTypeList(
-    const std::unordered_map<std::string, traffic_simulator_msgs::msg::EntityType> &
+    const std::shared_ptr<const entity_behavior::BehaviorPluginBase::EntityTypeDict> &
       entity_type_list)
   {
     entity_type_list_ = entity_type_list;
@@ -115,8 +126,17 @@ public:
     hdmap_utils_ptr_ = ptr;
   }
 
-  /*   */ void setOtherStatus(
-    const std::unordered_map<std::string, traffic_simulator_msgs::msg::EntityStatus> & status);
+  /*   */ void setLaneletEntityIndex(
+    const std::shared_ptr<const entity_behavior::LaneletEntityIndex> & lanelet_entity_index)
+  {
+    lanelet_entity_index_ = lanelet_entity_index;
+  }
+
+  /**
+   * @brief Keep the statuses of the other entities closer than other_entity_range, looked up in
+   * the index.
+   */
+  /*   */ void setOtherStatus(const entity_behavior::LaneletEntityIndex & lanelet_entity_index);
 
   virtual auto setStatus(const traffic_simulator_msgs::msg::EntityStatus & status) -> bool;
 
@@ -139,6 +159,28 @@ public:
 
   virtual void onUpdate(double current_time, double step_time);
 
+  /**
+   * @brief Cheap substitute of onUpdate for entities far from the ego.
+   * Keeps the current speed and follows the route (or heading, if the entity is not on any lane)
+   * without evaluating the behavior plugin. Stops for one frame at stop lines, and at the stop
+   * lines of red and yellow traffic lights until they change.
+   */
+  virtual void onKinematicUpdate(double current_time, double step_time);
+
+  /**
+   * @brief Behavior plugin of this entity if it supports batch update, otherwise nullptr.
+   * Such entities are updated by onPreBatchUpdate, BehaviorPluginBase::updateBatch and
+   * onPostBatchUpdate instead of onUpdate.
+   */
+  virtual auto getBatchBehaviorPlugin() const -> entity_behavior::BehaviorPluginBase *
+  {
+    return nullptr;
+  }
+
+  virtual void onPreBatchUpdate(double, double) {}
+
+  virtual void onPostBatchUpdate(double, double) {}
+
   virtual auto ready() const -> bool { return static_cast<bool>(status_); }
 
   virtual void requestAcquirePosition(
@@ -196,6 +238,7 @@ protected:
   boost::optional<traffic_simulator_msgs::msg::LaneletPose> next_waypoint_;
   boost::optional<traffic_simulator_msgs::msg::EntityStatus> status_;
   boost::optional<traffic_simulator_msgs::msg::EntityStatus> status_before_update_;
+  boost::optional<std::shared_ptr<const math::CatmullRomSpline>> waypoints_spline_;
 
   std::queue<traffic_simulator_msgs::msg::LaneletPose> waypoints_;
 
@@ -206,13 +249,33 @@ protected:
   bool visibility_;
 
   std::unordered_map<std::string, traffic_simulator_msgs::msg::EntityStatus> other_status_;
-  std::unordered_map<std::string, traffic_simulator_msgs::msg::EntityType> entity_type_list_;
+  std::shared_ptr<const entity_behavior::BehaviorPluginBase::EntityTypeDict> entity_type_list_;
+  std::shared_ptr<const entity_behavior::LaneletEntityIndex> lanelet_entity_index_;
 
   boost::optional<double> linear_jerk_;
   boost::optional<double> stand_still_duration_;
 
   visualization_msgs::msg::MarkerArray current_marker_;
   traffic_simulator_msgs::msg::EntityType entity_type_;
+
+private:
+  struct KinematicStop
+  {
+    double speed;
+    boost::optional<std::int64_t> traffic_light_id;
+  };
+
+  /**
+   * @brief Nearest stop line on route_lanelets in (from, to], with the traffic light it belongs
+   * to. Stop lines of traffic lights are only taken while the light is red or yellow.
+   * @note from and to are measured from the start of route_lanelets.front().
+   */
+  auto findKinematicStop(
+    const std::vector<std::int64_t> & route_lanelets, double from, double to) const
+    -> boost::optional<std::pair<double, KinematicStop>>;
+
+  // Set while onKinematicUpdate holds the entity at a stop line, with the speed to resume at.
+  boost::optional<KinematicStop> kinematic_stop_;
 };
 }  // namespace entity
 }  // namespace traffic_simulator
@@ -22,6 +22,7 @@
 
 #include <boost/optional.hpp>
 #include <memory>
+#include <nlohmann/json.hpp>
 #include <rclcpp/node_interfaces/get_node_topics_interface.hpp>
 #include <rclcpp/node_interfaces/node_topics_interface.hpp>
 #include <rclcpp/rclcpp.hpp>
@@ -29,13 +30,17 @@
 #include <stdexcept>
 #include <string>
 #include <traffic_simulator/api/configuration.hpp>
+#include <traffic_simulator/behavior/behavior_tree_profiler.hpp>
 #include <traffic_simulator/data_type/data_types.hpp>
 #include <traffic_simulator/entity/ego_entity.hpp>
 #include <traffic_simulator/entity/entity_base.hpp>
+#include <traffic_simulator/entity/entity_store.hpp>
+#include <traffic_simulator/entity/level_of_detail_scheduler.hpp>
 #include <traffic_simulator/entity/misc_object_entity.hpp>
 #include <traffic_simulator/entity/pedestrian_entity.hpp>
 #include <traffic_simulator/entity/vehicle_entity.hpp>
 #include <traffic_simulator/hdmap_utils/hdmap_utils.hpp>
+#include <traffic_simulator/helper/histogram.hpp>
 #include <traffic_simulator/traffic/traffic_sink.hpp>
 #include <traffic_simulator/traffic_lights/traffic_light_manager.hpp>
 #include <traffic_simulator_msgs/msg/bounding_box.hpp>
@@ -75,16 +80,38 @@ class EntityManager
 
   const rclcpp::Clock::SharedPtr clock_ptr_;
 
-  std::unordered_map<std::string, std::unique_ptr<traffic_simulator::entity::EntityBase>> entities_;
+  EntityStore entity_store_;
+
+  LevelOfDetailScheduler level_of_detail_scheduler_{
+    configuration.lod_full_radius, configuration.lod_reduced_radius,
+    configuration.lod_reduced_interval};
 
   double step_time_;
 
   double current_time_;
 
+  helper::Histogram frame_update_histogram_;
+
+  // indexed by entity handle, in the same order as entity_store_
+  std::vector<helper::Histogram> entity_update_histograms_;
+
+  // Entity update times of despawned entities, keyed by name. An entity respawned under the same
+  // name adds to its earlier histogram.
+  std::unordered_map<std::string, helper::Histogram> despawned_entity_update_histograms_;
+
+  std::unordered_map<std::string, helper::Histogram> behavior_plugin_update_histograms_;
+
   using EntityStatusWithTrajectoryArray =
     traffic_simulator_msgs::msg::EntityStatusWithTrajectoryArray;
   const rclcpp::Publisher<EntityStatusWithTrajectoryArray>::SharedPtr entity_status_array_pub_ptr_;
 
+  boost::optional<double> last_entity_status_publish_time_;
+
+  std::size_t entity_status_subscription_count_ = 0;
+
+  std::unordered_map<std::string, traffic_simulator_msgs::msg::EntityStatusWithTrajectory>
+    published_trajectories_;
+
   using MarkerArray = visualization_msgs::msg::MarkerArray;
   const rclcpp::Publisher<MarkerArray>::SharedPtr lanelet_marker_pub_ptr_;
 
@@ -149,10 +176,17 @@ public:
     markers_raw_(hdmap_utils_ptr_->generateMarker()),
     traffic_light_manager_ptr_(makeTrafficLightManager(hdmap_utils_ptr_, node))
   {
+    // The profiler is process-wide, so each EntityManager starts it from an empty profile.
+    entity_behavior::BehaviorTreeProfiler::get().clear();
+    entity_behavior::BehaviorTreeProfiler::get().enable(configuration.profile_behavior_trees);
     updateHdmapMarker();
   }
 
-  ~EntityManager() = default;
+  ~EntityManager()
+  {
+    entity_behavior::BehaviorTreeProfiler::get().enable(false);
+    entity_behavior::BehaviorTreeProfiler::get().clear();
+  }
 
 public:
 #define DEFINE_SET_TRAFFIC_LIGHT(NAME)                                               \
@@ -198,17 +232,16 @@ public:
 
 #undef FORWARD_TO_HDMAP_UTILS
 
-#define FORWARD_TO_ENTITY(IDENTIFIER, ...)                                     \
-  template <typename... Ts>                                                    \
-  decltype(auto) IDENTIFIER(const std::string & name, Ts &&... xs) __VA_ARGS__ \
-  try {                                                                        \
-    return entities_.at(name)->IDENTIFIER(std::forward<decltype(xs)>(xs)...);  \
-  } catch (const std::out_of_range &) {                                        \
-    THROW_SEMANTIC_ERROR("entity : ", name, "does not exist");                 \
-  }                                                                            \
+#define FORWARD_TO_ENTITY(IDENTIFIER, ...)                                            \
+  template <typename... Ts>                                                           \
+  decltype(auto) IDENTIFIER(const std::string & name, Ts &&... xs) __VA_ARGS__        \
+  try {                                                                               \
+    return entity_store_.entity(name)->IDENTIFIER(std::forward<decltype(xs)>(xs)...); \
+  } catch (const std::out_of_range &) {                                               \
+    THROW_SEMANTIC_ERROR("entity : ", name, "does not exist");                        \
+  }                                                                                   \
   static_assert(true, "")
 
-  FORWARD_TO_ENTITY(cancelRequest, );
   FORWARD_TO_ENTITY(engage, );
   FORWARD_TO_ENTITY(getBoundingBox, const);
   FORWARD_TO_ENTITY(getCurrentAction, const);
@@ -221,10 +254,6 @@ public:
   FORWARD_TO_ENTITY(getVehicleCommand, const);
   FORWARD_TO_ENTITY(getVehicleParameters, const);
   FORWARD_TO_ENTITY(ready, const);
-  FORWARD_TO_ENTITY(requestAcquirePosition, );
-  FORWARD_TO_ENTITY(requestAssignRoute, );
-  FORWARD_TO_ENTITY(requestLaneChange, );
-  FORWARD_TO_ENTITY(requestWalkStraight, );
   FORWARD_TO_ENTITY(setAccelerationLimit, );
   FORWARD_TO_ENTITY(setDecelerationLimit, );
   FORWARD_TO_ENTITY(setDriverModel, );
@@ -232,6 +261,25 @@ public:
 
 #undef FORWARD_TO_SPECIFIED_ENTITY
 
+#define FORWARD_REQUEST_TO_ENTITY(IDENTIFIER)                                         \
+  template <typename... Ts>                                                           \
+  decltype(auto) IDENTIFIER(const std::string & name, Ts &&... xs)                    \
+  try {                                                                               \
+    requestBehaviorUpdate(name);                                                      \
+    return entity_store_.entity(name)->IDENTIFIER(std::forward<decltype(xs)>(xs)...); \
+  } catch (const std::out_of_range &) {                                               \
+    THROW_SEMANTIC_ERROR("entity : ", name, "does not exist");                        \
+  }                                                                                   \
+  static_assert(true, "")
+
+  FORWARD_REQUEST_TO_ENTITY(cancelRequest);
+  FORWARD_REQUEST_TO_ENTITY(requestAcquirePosition);
+  FORWARD_REQUEST_TO_ENTITY(requestAssignRoute);
+  FORWARD_REQUEST_TO_ENTITY(requestLaneChange);
+  FORWARD_REQUEST_TO_ENTITY(requestWalkStraight);
+
+#undef FORWARD_REQUEST_TO_ENTITY
+
   visualization_msgs::msg::MarkerArray makeDebugMarker() const;
 
   bool trafficLightsChanged();
@@ -255,6 +303,24 @@ public:
     const std::string & name,
     const std::unordered_map<std::string, traffic_simulator_msgs::msg::EntityType> & type_list);
 
+  /**
+   * @note The entity uses the entity type list set to it for the current frame.
+   */
+  traffic_simulator_msgs::msg::EntityStatus updateNpcLogic(const EntityStore::Handle handle);
+
+  traffic_simulator_msgs::msg::EntityStatus updateNpcLogicKinematically(const std::string & name);
+
+  traffic_simulator_msgs::msg::EntityStatus updateNpcLogicKinematically(
+    const EntityStore::Handle handle);
+
+  /**
+   * @brief Updates entities whose behavior plugins are of the same type with one
+   * BehaviorPluginBase::updateBatch call.
+   */
+  void updateNpcLogicInBatch(
+    const std::vector<EntityStore::Handle> & handles,
+    const entity_behavior::BehaviorPluginBase::WorldSnapshot & world);
+
   void broadcastEntityTransform();
 
   void broadcastTransform(
@@ -271,6 +337,9 @@ public:
   // TODO (yamacir-kit) Rename to 'hasEntityStatus'
   bool entityStatusSet(const std::string & name) const;
 
+  auto getBehaviorPluginUpdateHistogram(const std::string & plugin_name) const
+    -> const helper::Histogram &;
+
   auto getBoundingBoxDistance(const std::string & from, const std::string & to)
     -> boost::optional<double>;
 
@@ -282,16 +351,26 @@ public:
   auto getDistanceToStopLine(const std::string & name, const std::int64_t target_stop_line_id)
     -> boost::optional<double>;
 
+  auto getEntityHandle(const std::string & name) const -> EntityStore::Handle;
+
   auto getEntityNames() const -> const std::vector<std::string>;
 
   auto getEntityStatus(const std::string & name) const
     -> const boost::optional<traffic_simulator_msgs::msg::EntityStatus>;
 
+  auto getEntityStore() const noexcept -> const EntityStore &;
+
+  auto getEntityUpdateHistogram(const std::string & name) const -> const helper::Histogram &;
+
   auto getEntityTypeList() const
     -> const std::unordered_map<std::string, traffic_simulator_msgs::msg::EntityType>;
 
   auto getHdmapUtils() -> const std::shared_ptr<hdmap_utils::HdMapUtils> &;
 
+  auto getLevelOfDetail(const std::string & name) const -> LevelOfDetail;
+
+  auto getLevelOfDetailStatistics() const noexcept -> const LevelOfDetailStatistics &;
+
   auto getLaneletPose(const std::string & name)
     -> boost::optional<traffic_simulator_msgs::msg::LaneletPose>;
 
@@ -321,6 +400,13 @@ public:
 
   auto getStepTime() const noexcept -> double;
 
+  /**
+   * @brief Update time histograms of the frame, of each entity, of each despawned entity and of
+   * each behavior plugin, and the behavior tree profile if Configuration::profile_behavior_trees is
+   * set.
+   */
+  auto getUpdateCostReport() const -> nlohmann::json;
+
   auto getWaypoints(const std::string & name) -> traffic_simulator_msgs::msg::WaypointsArray;
 
   void getGoalPoses(
@@ -355,15 +441,12 @@ public:
   template <typename Entity, typename... Ts>
   auto spawnEntity(const std::string & name, Ts &&... xs)
   {
-    const auto result =
-      entities_.emplace(name, std::make_unique<Entity>(name, std::forward<decltype(xs)>(xs)...));
-    if (result.second) {
-      result.first->second->setHdMapUtils(hdmap_utils_ptr_);
-      result.first->second->setTrafficLightManager(traffic_light_manager_ptr_);
-      return result.second;
-    } else {
-      THROW_SEMANTIC_ERROR("entity : ", name, " is already exists.");
-    }
+    auto entity = std::make_unique<Entity>(name, std::forward<decltype(xs)>(xs)...);
+    const auto bounding_box = entity->getBoundingBox();
+    const auto handle = entity_store_.add(name, std::move(entity), bounding_box);
+    entity_store_.entity(handle)->setHdMapUtils(hdmap_utils_ptr_);
+    entity_store_.entity(handle)->setTrafficLightManager(traffic_light_manager_ptr_);
+    return true;
   }
 
   auto toMapPose(const traffic_simulator_msgs::msg::LaneletPose &) const
@@ -385,6 +468,22 @@ public:
   void update(const double current_time, const double step_time);
 
   void updateHdmapMarker();
+
+  /**
+   * @brief Write getUpdateCostReport to Configuration::update_cost_log_path, if it is set.
+   * @note Called by the user at the end of the scenario, so that the report covers all of it.
+   */
+  auto writeUpdateCostLog() const -> void;
+
+private:
+  auto getLevelOfDetailReferencePositions() const -> std::vector<geometry_msgs::msg::Point>;
+
+  void publishEntityStatusArray(
+    const std::unordered_map<std::string, traffic_simulator_msgs::msg::EntityStatus> &);
+
+  // Lets the entity evaluate its behavior plugin in the next frame whatever its level of detail,
+  // so that reduced and kinematic entities do not miss requests.
+  void requestBehaviorUpdate(const std::string & name);
 };
 }  // namespace entity
 }  // namespace traffic_simulator
@@ -0,0 +1,133 @@
+// Copyright 2015-2020 Tier IV, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef TRAFFIC_SIMULATOR__ENTITY__ENTITY_STORE_HPP_
+#define TRAFFIC_SIMULATOR__ENTITY__ENTITY_STORE_HPP_
+
+#include <boost/optional.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <geometry_msgs/msg/accel.hpp>
+#include <geometry_msgs/msg/pose.hpp>
+#include <geometry_msgs/msg/twist.hpp>
+#include <memory>
+#include <string>
+#include <traffic_simulator/entity/entity_base.hpp>
+#include <traffic_simulator_msgs/msg/bounding_box.hpp>
+#include <traffic_simulator_msgs/msg/entity_status.hpp>
+#include <traffic_simulator_msgs/msg/lanelet_pose.hpp>
+#include <unordered_map>
+#include <vector>
+
+namespace traffic_simulator
+{
+namespace entity
+{
+/**
+ * @brief Structure-of-arrays storage of entity states.
+ * Each entity is addressed by a dense integer handle in [0, size()), so bulk processing can walk
+ * contiguous arrays without hashing entity names. The name to handle table is only a lookup layer
+ * for the name-based API. The store owns the entities, in spawn order.
+ * @note Handles are stable until an entity is removed. Removal erases the slot in place, so the
+ * handles of the entities spawned after the removed one are decremented by one.
+ */
+class EntityStore
+{
+public:
+  using Handle = std::size_t;
+
+  auto add(
+    const std::string & name, std::unique_ptr<EntityBase> entity,
+    const traffic_simulator_msgs::msg::BoundingBox & bounding_box =
+      traffic_simulator_msgs::msg::BoundingBox()) -> Handle;
+
+  auto contains(const std::string & name) const -> bool;
+
+  auto find(const std::string & name) const -> boost::optional<Handle>;
+
+  auto handle(const std::string & name) const -> Handle;
+
+  auto remove(const std::string & name) -> bool;
+
+  auto size() const noexcept -> std::size_t { return names_.size(); }
+
+  auto empty() const noexcept -> bool { return names_.empty(); }
+
+  void clear();
+
+  void update(const Handle, const traffic_simulator_msgs::msg::EntityStatus &);
+
+  auto accels() const noexcept -> const std::vector<geometry_msgs::msg::Accel> & { return accels_; }
+
+  auto bounding_boxes() const noexcept
+    -> const std::vector<traffic_simulator_msgs::msg::BoundingBox> &
+  {
+    return bounding_boxes_;
+  }
+
+  auto entities() const noexcept -> const std::vector<std::unique_ptr<EntityBase>> &
+  {
+    return entities_;
+  }
+
+  auto lanelet_pose_valid() const noexcept -> const std::vector<std::uint8_t> &
+  {
+    return lanelet_pose_valid_;
+  }
+
+  auto lanelet_poses() const noexcept
+    -> const std::vector<traffic_simulator_msgs::msg::LaneletPose> &
+  {
+    return lanelet_poses_;
+  }
+
+  auto names() const noexcept -> const std::vector<std::string> & { return names_; }
+
+  auto poses() const noexcept -> const std::vector<geometry_msgs::msg::Pose> & { return poses_; }
+
+  auto status_set() const noexcept -> const std::vector<std::uint8_t> & { return status_set_; }
+
+  auto twists() const noexcept -> const std::vector<geometry_msgs::msg::Twist> & { return twists_; }
+
+  auto entity(const Handle handle) const -> EntityBase * { return entities_.at(handle).get(); }
+
+  auto entity(const std::string & name) const -> EntityBase *;
+
+  auto name(const Handle handle) const -> const std::string & { return names_.at(handle); }
+
+private:
+  std::unordered_map<std::string, Handle> handles_;
+
+  std::vector<std::string> names_;
+
+  std::vector<std::unique_ptr<EntityBase>> entities_;
+
+  std::vector<std::uint8_t> status_set_;
+
+  std::vector<geometry_msgs::msg::Pose> poses_;
+
+  std::vector<geometry_msgs::msg::Twist> twists_;
+
+  std::vector<geometry_msgs::msg::Accel> accels_;
+
+  std::vector<traffic_simulator_msgs::msg::BoundingBox> bounding_boxes_;
+
+  std::vector<traffic_simulator_msgs::msg::LaneletPose> lanelet_poses_;
+
+  std::vector<std::uint8_t> lanelet_pose_valid_;
+};
+}  // namespace entity
+}  // namespace traffic_simulator
+
+#endif  // TRAFFIC_SIMULATOR__ENTITY__ENTITY_STORE_HPP_
@@ -0,0 +1,121 @@
+// Copyright 2015-2020 Tier IV, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef TRAFFIC_SIMULATOR__ENTITY__LEVEL_OF_DETAIL_SCHEDULER_HPP_
+#define TRAFFIC_SIMULATOR__ENTITY__LEVEL_OF_DETAIL_SCHEDULER_HPP_
+
+#include <cstddef>
+#include <geometry_msgs/msg/point.hpp>
+#include <iostream>
+#include <vector>
+
+namespace traffic_simulator
+{
+namespace entity
+{
+enum class LevelOfDetail {
+  FULL,       // behavior plugin is evaluated every frame
+  REDUCED,    // behavior plugin is evaluated every `reduced_interval` frames
+  KINEMATIC,  // behavior plugin is never evaluated, only kinematic lane following
+};
+
+auto operator<<(std::ostream &, const LevelOfDetail &) -> std::ostream &;
+
+struct LevelOfDetailStatistics
+{
+  std::size_t full = 0;
+
+  std::size_t reduced = 0;
+
+  std::size_t kinematic = 0;
+
+  // number of entities whose behavior plugin was evaluated in the frame
+  std::size_t behavior_updates = 0;
+};
+
+auto operator<<(std::ostream &, const LevelOfDetailStatistics &) -> std::ostream &;
+
+/**
+ * @brief Decides how accurately each entity is updated in a frame, from its distance to the
+ * nearest reference position (e.g. the ego vehicle).
+ * Decisions depend only on positions and the order of calls, so the schedule is deterministic.
+ * If no radius is given or no reference position exists, every entity is updated at full detail.
+ * @note Entities are addressed by their EntityStore handle, so scheduling does not hash names.
+ */
+class LevelOfDetailScheduler
+{
+public:
+  explicit LevelOfDetailScheduler(
+    const double full_radius = 0, const double reduced_radius = 0,
+    const std::size_t reduced_interval = 1);
+
+  auto enabled() const noexcept -> bool { return full_radius_ > 0; }
+
+  void beginFrame(const std::vector<geometry_msgs::msg::Point> & reference_positions);
+
+  auto classify(const geometry_msgs::msg::Point & position) const -> LevelOfDetail;
+
+  /**
+   * @brief Classify the entity and count it into the statistics of this frame.
+   * @return true if the behavior plugin of the entity should be evaluated in this frame.
+   */
+  auto schedule(const std::size_t handle, const geometry_msgs::msg::Point & position) -> bool;
+
+  /**
+   * @brief Evaluate the behavior plugin of the entity at its next schedule whatever its level of
+   * detail, e.g. because its request changed.
+   */
+  void requestBehaviorUpdate(const std::size_t handle);
+
+  /**
+   * @brief Forget the entity of the handle, shifting the states of the later handles down by one
+   * in the same way as EntityStore::remove.
+   */
+  void remove(const std::size_t handle);
+
+  auto getLevelOfDetail(const std::size_t handle) const -> LevelOfDetail;
+
+  auto getStatistics() const noexcept -> const LevelOfDetailStatistics & { return statistics_; }
+
+private:
+  struct State
+  {
+    bool scheduled = false;
+
+    LevelOfDetail level_of_detail = LevelOfDetail::FULL;
+
+    std::size_t skipped_frames = 0;
+
+    bool behavior_update_requested = false;
+  };
+
+  const double full_radius_;
+
+  const double reduced_radius_;
+
+  const std::size_t reduced_interval_;
+
+  std::vector<geometry_msgs::msg::Point> reference_positions_;
+
+  // indexed by entity handle
+  std::vector<State> states_;
+
+  std::size_t scheduled_entities_ = 0;
+
+  LevelOfDetailStatistics statistics_;
+};
+}  // namespace entity
+}  // namespace traffic_simulator
+
+#endif  // TRAFFIC_SIMULATOR__ENTITY__LEVEL_OF_DETAIL_SCHEDULER_HPP_
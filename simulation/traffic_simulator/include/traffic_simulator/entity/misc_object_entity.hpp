@@ -28,6 +28,11 @@ public:
   MiscObjectEntity(
     const std::string & name, const traffic_simulator_msgs::msg::MiscObjectParameters & params);
   void onUpdate(double, double) override;
+
+  void onKinematicUpdate(double current_time, double step_time) override
+  {
+    onUpdate(current_time, step_time);
+  }
   auto getBoundingBox() const -> const traffic_simulator_msgs::msg::BoundingBox override;
   auto getCurrentAction() const -> const std::string override;
   auto getEntityTypename() const -> const std::string & override
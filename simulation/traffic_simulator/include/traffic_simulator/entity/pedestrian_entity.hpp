@@ -17,10 +17,10 @@
 
 #include <boost/optional.hpp>
 #include <memory>
-#include <pluginlib/class_loader.hpp>
 #include <pugixml.hpp>
 #include <string>
 #include <traffic_simulator/behavior/behavior_plugin_base.hpp>
+#include <traffic_simulator/behavior/behavior_plugin_loader.hpp>
 #include <traffic_simulator/behavior/route_planner.hpp>
 #include <traffic_simulator/behavior/target_speed_planner.hpp>
 #include <traffic_simulator/entity/entity_base.hpp>
@@ -48,6 +48,12 @@ public:
       return name;
     }
 
+    static auto crowd() noexcept -> const std::string &
+    {
+      static const std::string name = "behavior_tree_plugin/PedestrianCrowd";
+      return name;
+    }
+
     static auto defaultBehavior() noexcept -> const std::string & { return behaviorTree(); }
   };
 
@@ -62,6 +68,8 @@ public:
 
   void appendDebugMarker(visualization_msgs::msg::MarkerArray & marker_array) override;
 
+  auto getBehaviorPluginName() const -> const std::string & override { return plugin_name; }
+
   auto getEntityTypename() const -> const std::string & override
   {
     static const std::string result = "PedestrianEntity";
@@ -70,6 +78,15 @@ public:
 
   void onUpdate(double current_time, double step_time) override;
 
+  auto getBatchBehaviorPlugin() const -> entity_behavior::BehaviorPluginBase * override
+  {
+    return behavior_plugin_ptr_->supportsBatchUpdate() ? behavior_plugin_ptr_.get() : nullptr;
+  }
+
+  void onPreBatchUpdate(double current_time, double step_time) override;
+
+  void onPostBatchUpdate(double current_time, double step_time) override;
+
   void requestAcquirePosition(
     const traffic_simulator_msgs::msg::LaneletPose & lanelet_pose) override;
 
@@ -148,7 +165,8 @@ public:
   const std::string plugin_name;
 
 private:
-  pluginlib::ClassLoader<entity_behavior::BehaviorPluginBase> loader_;
+  void prepareBehaviorPluginUpdate();
+  void applyBehaviorPluginUpdate(double step_time);
   std::shared_ptr<entity_behavior::BehaviorPluginBase> behavior_plugin_ptr_;
   traffic_simulator::behavior::TargetSpeedPlanner target_speed_planner_;
   std::shared_ptr<traffic_simulator::RoutePlanner> route_planner_ptr_;
@@ -17,11 +17,11 @@
 
 #include <boost/optional.hpp>
 #include <memory>
-#include <pluginlib/class_loader.hpp>
 #include <pugixml.hpp>
 #include <rclcpp/rclcpp.hpp>
 #include <string>
 #include <traffic_simulator/behavior/behavior_plugin_base.hpp>
+#include <traffic_simulator/behavior/behavior_plugin_loader.hpp>
 #include <traffic_simulator/behavior/route_planner.hpp>
 #include <traffic_simulator/behavior/target_speed_planner.hpp>
 #include <traffic_simulator/entity/entity_base.hpp>
@@ -65,6 +65,8 @@ public:
 
   void appendDebugMarker(visualization_msgs::msg::MarkerArray & marker_array) override;
 
+  auto getBehaviorPluginName() const -> const std::string & override { return plugin_name; }
+
   auto getEntityTypename() const -> const std::string & override
   {
     static const std::string result = "VehicleEntity";
@@ -73,6 +75,15 @@ public:
 
   void onUpdate(double current_time, double step_time) override;
 
+  auto getBatchBehaviorPlugin() const -> entity_behavior::BehaviorPluginBase * override
+  {
+    return behavior_plugin_ptr_->supportsBatchUpdate() ? behavior_plugin_ptr_.get() : nullptr;
+  }
+
+  void onPreBatchUpdate(double current_time, double step_time) override;
+
+  void onPostBatchUpdate(double current_time, double step_time) override;
+
   void requestAcquirePosition(const traffic_simulator_msgs::msg::LaneletPose & lanelet_pose);
 
   void requestAcquirePosition(const geometry_msgs::msg::Pose & map_pose) override;
@@ -170,7 +181,8 @@ public:
   const std::string plugin_name;
 
 private:
-  pluginlib::ClassLoader<entity_behavior::BehaviorPluginBase> loader_;
+  void prepareBehaviorPluginUpdate();
+  void applyBehaviorPluginUpdate(double step_time);
   std::shared_ptr<entity_behavior::BehaviorPluginBase> behavior_plugin_ptr_;
   std::shared_ptr<traffic_simulator::RoutePlanner> route_planner_ptr_;
   traffic_simulator::behavior::TargetSpeedPlanner target_speed_planner_;
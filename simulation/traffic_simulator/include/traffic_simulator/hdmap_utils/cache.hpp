@@ -15,12 +15,14 @@
 #ifndef TRAFFIC_SIMULATOR__HDMAP_UTILS__CACHE_HPP_
 #define TRAFFIC_SIMULATOR__HDMAP_UTILS__CACHE_HPP_
 
+#include <algorithm>
 #include <boost/optional.hpp>
 #include <geometry_msgs/msg/point.hpp>
 #include <mutex>
 #include <scenario_simulator_exception/exception.hpp>
 #include <traffic_simulator/math/catmull_rom_spline.hpp>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 namespace hdmap_utils
@@ -131,6 +133,93 @@ private:
   std::unordered_map<std::int64_t, double> data_;
   std::mutex mutex_;
 };
+
+class ConflictingCrosswalkCache
+{
+public:
+  bool exists(std::int64_t lanelet_id)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (data_.find(lanelet_id) == data_.end()) {
+      return false;
+    }
+    return true;
+  }
+  std::vector<std::int64_t> getConflictingCrosswalkIds(std::int64_t lanelet_id)
+  {
+    if (!exists(lanelet_id)) {
+      THROW_SIMULATION_ERROR(
+        "conflicting crosswalks of : ", lanelet_id,
+        " does not exist in ConflictingCrosswalkCache.");
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    return data_.at(lanelet_id);
+  }
+  void appendData(std::int64_t lanelet_id, const std::vector<std::int64_t> & crosswalk_ids)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    data_[lanelet_id] = crosswalk_ids;
+  }
+
+private:
+  std::unordered_map<std::int64_t, std::vector<std::int64_t>> data_;
+  std::mutex mutex_;
+};
+
+class LaneletPolygonCache
+{
+public:
+  bool exists(std::int64_t lanelet_id)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (data_.find(lanelet_id) == data_.end()) {
+      return false;
+    }
+    return true;
+  }
+  std::vector<geometry_msgs::msg::Point> getPolygon(std::int64_t lanelet_id)
+  {
+    if (!exists(lanelet_id)) {
+      THROW_SIMULATION_ERROR(
+        "polygon of : ", lanelet_id, " does not exist in LaneletPolygonCache.");
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    return data_.at(lanelet_id);
+  }
+  std::pair<geometry_msgs::msg::Point, geometry_msgs::msg::Point> get2DBoundingBox(
+    std::int64_t lanelet_id)
+  {
+    if (!exists(lanelet_id)) {
+      THROW_SIMULATION_ERROR(
+        "polygon of : ", lanelet_id, " does not exist in LaneletPolygonCache.");
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    return bounding_boxes_.at(lanelet_id);
+  }
+  void appendData(std::int64_t lanelet_id, const std::vector<geometry_msgs::msg::Point> & polygon)
+  {
+    std::pair<geometry_msgs::msg::Point, geometry_msgs::msg::Point> bounding_box;
+    if (!polygon.empty()) {
+      bounding_box.first = polygon.front();
+      bounding_box.second = polygon.front();
+    }
+    for (const auto & point : polygon) {
+      bounding_box.first.x = std::min(bounding_box.first.x, point.x);
+      bounding_box.first.y = std::min(bounding_box.first.y, point.y);
+      bounding_box.second.x = std::max(bounding_box.second.x, point.x);
+      bounding_box.second.y = std::max(bounding_box.second.y, point.y);
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    data_[lanelet_id] = polygon;
+    bounding_boxes_[lanelet_id] = bounding_box;
+  }
+
+private:
+  std::unordered_map<std::int64_t, std::vector<geometry_msgs::msg::Point>> data_;
+  std::unordered_map<std::int64_t, std::pair<geometry_msgs::msg::Point, geometry_msgs::msg::Point>>
+    bounding_boxes_;
+  std::mutex mutex_;
+};
 }  // namespace hdmap_utils
 
 #endif  // TRAFFIC_SIMULATOR__HDMAP_UTILS__CACHE_HPP_
@@ -147,7 +147,11 @@ public:
   std::vector<std::int64_t> filterLaneletIds(
     const std::vector<std::int64_t> & lanelet_ids, const char subtype[]) const;
   const std::vector<geometry_msgs::msg::Point> getLaneletPolygon(std::int64_t lanelet_id);
+  auto getLaneletPolygon2DBoundingBox(std::int64_t lanelet_id)
+    -> std::pair<geometry_msgs::msg::Point, geometry_msgs::msg::Point>;
   const std::vector<geometry_msgs::msg::Point> getStopLinePolygon(std::int64_t lanelet_id);
+  std::vector<std::vector<geometry_msgs::msg::Point>> getStopLinesPointsOnPath(
+    const std::vector<std::int64_t> & lanelet_ids);
   std::vector<std::int64_t> getTrafficLightIds() const;
   const boost::optional<geometry_msgs::msg::Point> getTrafficLightBulbPosition(
     std::int64_t traffic_light_id, traffic_simulator::TrafficLightColor color) const;
@@ -176,6 +180,8 @@ private:
   RouteCache route_cache_;
   CenterPointsCache center_points_cache_;
   LaneletLengthCache lanelet_length_cache_;
+  mutable ConflictingCrosswalkCache conflicting_crosswalk_cache_;
+  LaneletPolygonCache lanelet_polygon_cache_;
   std::vector<lanelet::AutowareTrafficLightConstPtr> getTrafficLights(
     const std::int64_t traffic_light_id) const;
   std::vector<std::pair<double, lanelet::Lanelet>> excludeSubtypeLanelets(
@@ -0,0 +1,74 @@
+// Copyright 2015-2020 Tier IV, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef TRAFFIC_SIMULATOR__HELPER__HISTOGRAM_HPP_
+#define TRAFFIC_SIMULATOR__HELPER__HISTOGRAM_HPP_
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <nlohmann/json.hpp>
+
+namespace traffic_simulator
+{
+namespace helper
+{
+/**
+ * @brief Histogram of durations with exponentially growing buckets.
+ * The upper bound of the i-th bucket is 2^i microseconds. The last bucket is unbounded and holds
+ * every longer duration, so its upper bound is null in toJson.
+ */
+class Histogram
+{
+public:
+  static constexpr std::size_t number_of_buckets = 24;
+
+  void add(const std::chrono::nanoseconds & duration);
+
+  void merge(const Histogram & other);
+
+  auto count() const noexcept -> std::size_t { return count_; }
+
+  // all durations below are in seconds
+  auto max() const noexcept -> double { return max_; }
+
+  auto mean() const noexcept -> double { return count_ == 0 ? 0 : sum_ / count_; }
+
+  auto sum() const noexcept -> double { return sum_; }
+
+  /**
+   * @brief Upper bound of the bucket which contains the given quantile, or the maximum if that
+   * bucket is the unbounded last one.
+   * @param quantile in [0, 1]
+   */
+  auto percentile(const double quantile) const -> double;
+
+  static auto getUpperBound(const std::size_t bucket_index) -> double;
+
+  auto toJson() const -> nlohmann::json;
+
+private:
+  std::array<std::size_t, number_of_buckets> buckets_ = {};
+
+  std::size_t count_ = 0;
+
+  double sum_ = 0;
+
+  double max_ = 0;
+};
+
+}  // namespace helper
+}  // namespace traffic_simulator
+
+#endif  // TRAFFIC_SIMULATOR__HELPER__HISTOGRAM_HPP_
@@ -23,6 +23,7 @@
 #include <geometry_msgs/msg/pose.hpp>
 #include <geometry_msgs/msg/vector3.hpp>
 #include <traffic_simulator/math/polynomial_solver.hpp>
+#include <utility>
 #include <vector>
 
 namespace traffic_simulator
@@ -56,6 +57,11 @@ public:
   double getMaximum2DCurvature() const;
   double getLength(size_t num_points) const;
   double getLength() const { return length_; }
+  /**
+   * @brief Conservative 2D axis-aligned bounding box (minimum corner, maximum corner), taken from
+   * the Bezier control points of the curve.
+   */
+  std::pair<geometry_msgs::msg::Point, geometry_msgs::msg::Point> get2DBoundingBox() const;
   boost::optional<double> getSValue(
     const geometry_msgs::msg::Pose & pose, double threshold_distance = 3.0,
     bool autoscale = false) const;
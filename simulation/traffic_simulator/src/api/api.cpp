@@ -279,6 +279,9 @@ bool API::initialize(double realtime_factor, double step_time)
     simulation_api_schema::InitializeRequest req;
     req.set_step_time(step_time);
     req.set_realtime_factor(realtime_factor);
+    if (configuration.lidar_map_geometry) {
+      req.set_lanelet2_map_path(configuration.lanelet2_map_path().string());
+    }
     simulation_api_schema::InitializeResponse res;
     zeromq_client_.call(req, res);
     return res.result().success();
@@ -0,0 +1,49 @@
+// Copyright 2015-2020 Tier IV, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <memory>
+#include <string>
+#include <traffic_simulator/behavior/behavior_plugin_loader.hpp>
+
+namespace entity_behavior
+{
+BehaviorPluginLoader::BehaviorPluginLoader()
+: loader_(std::make_shared<pluginlib::ClassLoader<BehaviorPluginBase>>(
+    "traffic_simulator", "entity_behavior::BehaviorPluginBase"))
+{
+}
+
+auto BehaviorPluginLoader::get() -> BehaviorPluginLoader &
+{
+  static BehaviorPluginLoader loader;
+  return loader;
+}
+
+auto BehaviorPluginLoader::createSharedInstance(const std::string & plugin_name)
+  -> std::shared_ptr<BehaviorPluginBase>
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (loaded_plugin_names_.find(plugin_name) == loaded_plugin_names_.end()) {
+    loader_->loadLibraryForClass(plugin_name);
+    loaded_plugin_names_.emplace(plugin_name);
+  }
+  const auto instance = loader_->createSharedInstance(plugin_name);
+  // The class loader must outlive the instance, even if the entity outlives the registry.
+  return std::shared_ptr<BehaviorPluginBase>(
+    instance.get(), [instance, loader = loader_](BehaviorPluginBase *) mutable {
+      instance.reset();
+      loader.reset();
+    });
+}
+}  // namespace entity_behavior
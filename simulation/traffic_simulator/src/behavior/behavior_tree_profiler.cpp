@@ -0,0 +1,66 @@
+// Copyright 2015-2020 Tier IV, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <string>
+#include <traffic_simulator/behavior/behavior_tree_profiler.hpp>
+
+namespace entity_behavior
+{
+auto BehaviorTreeProfiler::get() -> BehaviorTreeProfiler &
+{
+  static BehaviorTreeProfiler profiler;
+  return profiler;
+}
+
+void BehaviorTreeProfiler::addTick(
+  const std::string & behavior, const std::string & node,
+  const std::chrono::nanoseconds & duration)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  profiles_[behavior].nodes[node].add(duration);
+}
+
+void BehaviorTreeProfiler::addUpdate(const std::string & behavior, const std::size_t ticks)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto & profile = profiles_[behavior];
+  profile.updates++;
+  profile.ticks += ticks;
+  profile.max_ticks_per_update = std::max(profile.max_ticks_per_update, ticks);
+}
+
+void BehaviorTreeProfiler::clear()
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  profiles_.clear();
+}
+
+auto BehaviorTreeProfiler::toJson() const -> nlohmann::json
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto json = nlohmann::json::object();
+  for (const auto & profile : profiles_) {
+    auto & behavior = json[profile.first];
+    behavior["updates"] = profile.second.updates;
+    behavior["ticks"] = profile.second.ticks;
+    behavior["max_ticks_per_update"] = profile.second.max_ticks_per_update;
+    behavior["nodes"] = nlohmann::json::object();
+    for (const auto & node : profile.second.nodes) {
+      behavior["nodes"][node.first] = node.second.toJson();
+    }
+  }
+  return json;
+}
+}  // namespace entity_behavior
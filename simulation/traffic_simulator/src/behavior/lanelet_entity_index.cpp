@@ -0,0 +1,106 @@
+// Copyright 2015-2020 Tier IV, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <traffic_simulator/behavior/lanelet_entity_index.hpp>
+#include <vector>
+
+namespace entity_behavior
+{
+LaneletEntityIndex::LaneletEntityIndex(
+  const std::shared_ptr<const EntityStatusDict> & entity_status, double cell_size)
+: entity_status_(entity_status), cell_size_(cell_size)
+{
+  for (const auto & each : *entity_status_) {
+    const auto & position = each.second.pose.position;
+    const auto & bounding_box = each.second.bounding_box;
+    max_bounding_radius_ = std::max(
+      max_bounding_radius_,
+      std::hypot(bounding_box.center.x, bounding_box.center.y) +
+        0.5 * std::hypot(bounding_box.dimensions.x, bounding_box.dimensions.y));
+    cells_[getCellKey(getCellIndex(position.x), getCellIndex(position.y))].emplace_back(
+      &each.second);
+    // The lanelet id of an entity whose lanelet pose is not valid is stale.
+    if (each.second.lanelet_pose_valid) {
+      entities_[each.second.lanelet_pose.lanelet_id].emplace_back(&each.second);
+    }
+  }
+}
+
+auto LaneletEntityIndex::getCellIndex(double value) const -> std::int64_t
+{
+  return static_cast<std::int64_t>(std::floor(value / cell_size_));
+}
+
+auto LaneletEntityIndex::getCellKey(std::int64_t column, std::int64_t row) -> std::int64_t
+{
+  return static_cast<std::int64_t>(
+    (static_cast<std::uint64_t>(column) << 32) ^ (static_cast<std::uint64_t>(row) & 0xFFFFFFFF));
+}
+
+auto LaneletEntityIndex::getEntityStatus(std::int64_t lanelet_id) const
+  -> const std::vector<const traffic_simulator_msgs::msg::EntityStatus *> &
+{
+  static const std::vector<const traffic_simulator_msgs::msg::EntityStatus *> none;
+  const auto iter = entities_.find(lanelet_id);
+  return iter == entities_.end() ? none : iter->second;
+}
+
+auto LaneletEntityIndex::getEntityStatus(
+  const geometry_msgs::msg::Point & position, double radius) const
+  -> std::vector<const traffic_simulator_msgs::msg::EntityStatus *>
+{
+  const auto is_close = [&](const traffic_simulator_msgs::msg::EntityStatus & status) {
+    const auto & p = status.pose.position;
+    return std::sqrt(
+             std::pow(p.x - position.x, 2) + std::pow(p.y - position.y, 2) +
+             std::pow(p.z - position.z, 2)) < radius;
+  };
+  std::vector<const traffic_simulator_msgs::msg::EntityStatus *> ret;
+  const auto min_column = getCellIndex(position.x - radius);
+  const auto max_column = getCellIndex(position.x + radius);
+  const auto min_row = getCellIndex(position.y - radius);
+  const auto max_row = getCellIndex(position.y + radius);
+  if (
+    (max_column - min_column + 1) * (max_row - min_row + 1) >
+    static_cast<std::int64_t>(cells_.size())) {
+    for (const auto & each : *entity_status_) {
+      if (is_close(each.second)) {
+        ret.emplace_back(&each.second);
+      }
+    }
+    return ret;
+  }
+  for (auto column = min_column; column <= max_column; column++) {
+    for (auto row = min_row; row <= max_row; row++) {
+      const auto iter = cells_.find(getCellKey(column, row));
+      if (iter != cells_.end()) {
+        for (const auto status : iter->second) {
+          if (is_close(*status)) {
+            ret.emplace_back(status);
+          }
+        }
+      }
+    }
+  }
+  return ret;
+}
+
+auto LaneletEntityIndex::empty(std::int64_t lanelet_id) const -> bool
+{
+  return entities_.find(lanelet_id) == entities_.end();
+}
+}  // namespace entity_behavior
@@ -12,6 +12,9 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <quaternion_operation/quaternion_operation.h>
+
+#include <cmath>
 #include <limits>
 #include <queue>
 #include <rclcpp/rclcpp.hpp>
@@ -19,6 +22,7 @@
 #include <string>
 #include <traffic_simulator/entity/entity_base.hpp>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 namespace traffic_simulator
@@ -36,7 +40,160 @@ void EntityBase::appendDebugMarker(visualization_msgs::msg::MarkerArray & /*mark
   return;
 }
 
-void EntityBase::onUpdate(double, double) { status_before_update_ = status_; }
+void EntityBase::onUpdate(double, double)
+{
+  status_before_update_ = status_;
+  waypoints_spline_ = boost::none;
+  kinematic_stop_ = boost::none;
+}
+
+namespace
+{
+auto isStopRequired(const TrafficLightColor color) -> bool
+{
+  return color == TrafficLightColor::RED or color == TrafficLightColor::YELLOW;
+}
+}  // namespace
+
+auto EntityBase::findKinematicStop(
+  const std::vector<std::int64_t> & route_lanelets, double from, double to) const
+  -> boost::optional<std::pair<double, KinematicStop>>
+{
+  boost::optional<std::pair<double, KinematicStop>> stop;
+  const auto update = [&](const double s, const boost::optional<std::int64_t> & traffic_light_id) {
+    if (from < s and s <= to and (not stop or s < stop->first)) {
+      stop = std::make_pair(s, KinematicStop{0, traffic_light_id});
+    }
+  };
+  double lanelet_start_s = 0;
+  for (const auto lanelet_id : route_lanelets) {
+    if (to < lanelet_start_s) {
+      break;
+    }
+    const auto lanelet_end_s = lanelet_start_s + hdmap_utils_ptr_->getLaneletLength(lanelet_id);
+    if (from < lanelet_end_s) {
+      const auto spline = hdmap_utils_ptr_->getCenterPointsSpline(lanelet_id);
+      for (const auto & stop_line : hdmap_utils_ptr_->getStopLinesPointsOnPath({lanelet_id})) {
+        if (const auto s = spline->getCollisionPointIn2D(stop_line)) {
+          update(lanelet_start_s + s.get(), boost::none);
+        }
+      }
+      if (traffic_light_manager_) {
+        for (const auto id : hdmap_utils_ptr_->getTrafficLightIdsOnPath({lanelet_id})) {
+          if (isStopRequired(traffic_light_manager_->getColor(id))) {
+            for (const auto & stop_line : hdmap_utils_ptr_->getTrafficLightStopLinesPoints(id)) {
+              if (const auto s = spline->getCollisionPointIn2D(stop_line)) {
+                update(lanelet_start_s + s.get(), id);
+              }
+            }
+          }
+        }
+      }
+    }
+    lanelet_start_s = lanelet_end_s;
+  }
+  return stop;
+}
+
+void EntityBase::onKinematicUpdate(double current_time, double step_time)
+{
+  status_before_update_ = status_;
+  waypoints_spline_ = boost::none;
+  if (!status_) {
+    return;
+  }
+  if (current_time < 0) {
+    updateEntityStatusTimestamp(current_time);
+    return;
+  }
+  auto status = status_.get();
+  // Distance between the stop line and the front of an entity that resumes from it, so that the
+  // entity does not stop at the same line again.
+  constexpr double resume_margin = 0.1;
+  bool resumed = false;
+  if (kinematic_stop_) {
+    if (
+      kinematic_stop_->traffic_light_id and traffic_light_manager_ and
+      isStopRequired(traffic_light_manager_->getColor(kinematic_stop_->traffic_light_id.get()))) {
+      status.action_status.twist = geometry_msgs::msg::Twist();
+    } else {
+      status.action_status.twist.linear.x = kinematic_stop_->speed;
+      kinematic_stop_ = boost::none;
+      resumed = true;
+    }
+  }
+  double distance = status.action_status.twist.linear.x * step_time;
+  if (status.lanelet_pose_valid) {
+    auto & lanelet_pose = status.lanelet_pose;
+    if (distance >= 0) {
+      const auto front = getBoundingBox().center.x + getBoundingBox().dimensions.x * 0.5;
+      const auto horizon = lanelet_pose.s + front + distance;
+      auto route_lanelets = getRouteLanelets(horizon);
+      if (route_lanelets.empty() or route_lanelets.front() != lanelet_pose.lanelet_id) {
+        route_lanelets = hdmap_utils_ptr_->getFollowingLanelets(lanelet_pose.lanelet_id, horizon);
+      }
+      const auto stop = findKinematicStop(
+        route_lanelets, lanelet_pose.s + front + (resumed ? resume_margin : 0), horizon);
+      if (stop) {
+        distance = stop->first - front - lanelet_pose.s;
+        kinematic_stop_ = stop->second;
+        kinematic_stop_->speed = status.action_status.twist.linear.x;
+        status.action_status.twist = geometry_msgs::msg::Twist();
+      }
+      lanelet_pose.s = lanelet_pose.s + distance;
+      for (std::size_t i = 0;; i++) {
+        const auto length = hdmap_utils_ptr_->getLaneletLength(route_lanelets[i]);
+        if (lanelet_pose.s <= length) {
+          lanelet_pose.lanelet_id = route_lanelets[i];
+          break;
+        }
+        if (i + 1 == route_lanelets.size()) {
+          lanelet_pose.lanelet_id = route_lanelets[i];
+          lanelet_pose.s = length;
+          status.action_status.twist = geometry_msgs::msg::Twist();
+          break;
+        }
+        lanelet_pose.s = lanelet_pose.s - length;
+      }
+    } else {
+      // Reversing entities go back along the first previous lanelet, as there is no route behind.
+      lanelet_pose.s = lanelet_pose.s + distance;
+      while (lanelet_pose.s < 0) {
+        const auto previous_ids = hdmap_utils_ptr_->getPreviousLaneletIds(lanelet_pose.lanelet_id);
+        if (previous_ids.empty()) {
+          lanelet_pose.s = 0;
+          status.action_status.twist = geometry_msgs::msg::Twist();
+          break;
+        }
+        lanelet_pose.lanelet_id = previous_ids.front();
+        lanelet_pose.s = lanelet_pose.s + hdmap_utils_ptr_->getLaneletLength(previous_ids.front());
+      }
+    }
+    status.pose = hdmap_utils_ptr_->toMapPose(lanelet_pose).pose;
+  } else {
+    const auto yaw = quaternion_operation::convertQuaternionToEulerAngle(status.pose.orientation).z;
+    status.pose.position.x = status.pose.position.x + distance * std::cos(yaw);
+    status.pose.position.y = status.pose.position.y + distance * std::sin(yaw);
+  }
+  status.action_status.accel = geometry_msgs::msg::Accel();
+  status.time = current_time + step_time;
+  linear_jerk_ = 0;
+  setStatus(status);
+  updateStandStillDuration(step_time);
+}
+
+auto EntityBase::getWaypointsSpline() -> std::shared_ptr<const math::CatmullRomSpline>
+{
+  if (!waypoints_spline_) {
+    const auto waypoints = getWaypoints().waypoints;
+    if (waypoints.empty()) {
+      waypoints_spline_ = std::shared_ptr<const math::CatmullRomSpline>();
+    } else {
+      waypoints_spline_ = std::make_shared<const math::CatmullRomSpline>(waypoints);
+    }
+  }
+  return waypoints_spline_.get();
+}
 
 boost::optional<double> EntityBase::getStandStillDuration() const { return stand_still_duration_; }
 
@@ -160,20 +317,14 @@ void EntityBase::updateEntityStatusTimestamp(const double current_time)
   }
 }
 
-void EntityBase::setOtherStatus(
-  const std::unordered_map<std::string, traffic_simulator_msgs::msg::EntityStatus> & status)
+void EntityBase::setOtherStatus(const entity_behavior::LaneletEntityIndex & lanelet_entity_index)
 {
   other_status_.clear();
   if (status_) {
-    for (const auto & each : status) {
-      if (each.first != name) {
-        const auto p0 = each.second.pose.position;
-        const auto p1 = status_.get().pose.position;
-        double distance =
-          std::sqrt(std::pow(p0.x - p1.x, 2) + std::pow(p0.y - p1.y, 2) + std::pow(p0.z - p1.z, 2));
-        if (distance < 30) {
-          other_status_.insert(each);
-        }
+    for (const auto status : lanelet_entity_index.getEntityStatus(
+           status_->pose.position, entity_behavior::BehaviorPluginBase::other_entity_range)) {
+      if (status->name != name) {
+        other_status_.emplace(status->name, *status);
       }
     }
   }
@@ -12,8 +12,13 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <algorithm>
+#include <boost/optional.hpp>
+#include <chrono>
 #include <cstdint>
+#include <fstream>
 #include <limits>
+#include <map>
 #include <memory>
 #include <queue>
 #include <scenario_simulator_exception/exception.hpp>
@@ -26,6 +31,7 @@
 #include <traffic_simulator/math/collision.hpp>
 #include <traffic_simulator/math/transform.hpp>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 namespace traffic_simulator
@@ -91,25 +97,48 @@ bool EntityManager::checkCollision(const std::string & name0, const std::string
 visualization_msgs::msg::MarkerArray EntityManager::makeDebugMarker() const
 {
   visualization_msgs::msg::MarkerArray marker;
-  for (const auto & entity : entities_) {
-    entity.second->appendDebugMarker(marker);
+  for (const auto & entity : entity_store_.entities()) {
+    entity->appendDebugMarker(marker);
   }
   return marker;
 }
 
 bool EntityManager::despawnEntity(const std::string & name)
 {
-  return entityExists(name) && entities_.erase(name);
+  if (not entityExists(name)) {
+    return false;
+  }
+  /**
+   * @note Per-entity states indexed by handle follow the removal of EntityStore, which erases the
+   * slot of the removed entity and shifts the later ones down by one.
+   */
+  const auto handle = getEntityHandle(name);
+  level_of_detail_scheduler_.remove(handle);
+  if (handle < entity_update_histograms_.size()) {
+    despawned_entity_update_histograms_[name].merge(entity_update_histograms_[handle]);
+    entity_update_histograms_.erase(entity_update_histograms_.begin() + handle);
+  }
+  return entity_store_.remove(name);
 }
 
 bool EntityManager::entityExists(const std::string & name)
 {
-  return entities_.find(name) != std::end(entities_);
+  return entity_store_.contains(name);
 }
 
 bool EntityManager::entityStatusSet(const std::string & name) const
 {
-  return entities_.at(name)->statusSet();
+  return entity_store_.entity(name)->statusSet();
+}
+
+auto EntityManager::getBehaviorPluginUpdateHistogram(const std::string & plugin_name) const
+  -> const helper::Histogram &
+{
+  const auto iter = behavior_plugin_update_histograms_.find(plugin_name);
+  if (iter == behavior_plugin_update_histograms_.end()) {
+    THROW_SEMANTIC_ERROR("behavior plugin : ", plugin_name, " has never been updated.");
+  }
+  return iter->second;
 }
 
 auto EntityManager::getBoundingBoxDistance(const std::string & from, const std::string & to)
@@ -127,51 +156,57 @@ auto EntityManager::getCurrentTime() const noexcept -> double { return current_t
 auto EntityManager::getDistanceToCrosswalk(
   const std::string & name, const std::int64_t target_crosswalk_id) -> boost::optional<double>
 {
-  const auto it = entities_.find(name);
-  if (it == entities_.end()) {
+  const auto handle = entity_store_.find(name);
+  if (not handle) {
+    return boost::none;
+  }
+  const auto spline = entity_store_.entity(handle.get())->getWaypointsSpline();
+  if (!spline) {
     return boost::none;
   }
-  if (getWaypoints(name).waypoints.empty()) {
+  const auto polygon_bounding_box =
+    hdmap_utils_ptr_->getLaneletPolygon2DBoundingBox(target_crosswalk_id);
+  const auto spline_bounding_box = spline->get2DBoundingBox();
+  if (
+    polygon_bounding_box.second.x < spline_bounding_box.first.x or
+    spline_bounding_box.second.x < polygon_bounding_box.first.x or
+    polygon_bounding_box.second.y < spline_bounding_box.first.y or
+    spline_bounding_box.second.y < polygon_bounding_box.first.y) {
     return boost::none;
   }
-  traffic_simulator::math::CatmullRomSpline spline(getWaypoints(name).waypoints);
-  auto polygon = hdmap_utils_ptr_->getLaneletPolygon(target_crosswalk_id);
-  return spline.getCollisionPointIn2D(polygon);
+  return spline->getCollisionPointIn2D(hdmap_utils_ptr_->getLaneletPolygon(target_crosswalk_id));
 }
 
 auto EntityManager::getDistanceToStopLine(
   const std::string & name, const std::int64_t target_stop_line_id) -> boost::optional<double>
 {
-  auto it = entities_.find(name);
-  if (it == entities_.end()) {
+  const auto handle = entity_store_.find(name);
+  if (not handle) {
     return boost::none;
   }
-  if (getWaypoints(name).waypoints.empty()) {
+  const auto spline = entity_store_.entity(handle.get())->getWaypointsSpline();
+  if (!spline) {
     return boost::none;
   }
-  traffic_simulator::math::CatmullRomSpline spline(getWaypoints(name).waypoints);
   auto polygon = hdmap_utils_ptr_->getStopLinePolygon(target_stop_line_id);
-  return spline.getCollisionPointIn2D(polygon);
+  return spline->getCollisionPointIn2D(polygon);
+}
+
+auto EntityManager::getEntityHandle(const std::string & name) const -> EntityStore::Handle
+{
+  return entity_store_.handle(name);
 }
 
 auto EntityManager::getEntityNames() const -> const std::vector<std::string>
 {
-  std::vector<std::string> names{};
-  for (const auto & each : entities_) {
-    names.push_back(each.first);
-  }
-  return names;
+  return entity_store_.names();
 }
 
 auto EntityManager::getEntityStatus(const std::string & name) const
   -> const boost::optional<traffic_simulator_msgs::msg::EntityStatus>
 {
   traffic_simulator_msgs::msg::EntityStatus status_msg;
-  auto it = entities_.find(name);
-  if (it == entities_.end()) {
-    THROW_SEMANTIC_ERROR("entity : ", name, " does not exist.");
-  }
-  status_msg = it->second->getStatus();
+  status_msg = entity_store_.entity(name)->getStatus();
   status_msg.bounding_box = getBoundingBox(name);
   status_msg.action_status.current_action = getCurrentAction(name);
   switch (getEntityType(name).type) {
@@ -190,12 +225,26 @@ auto EntityManager::getEntityStatus(const std::string & name) const
   return status_msg;
 }
 
+auto EntityManager::getEntityStore() const noexcept -> const EntityStore & { return entity_store_; }
+
+auto EntityManager::getEntityUpdateHistogram(const std::string & name) const
+  -> const helper::Histogram &
+{
+  const auto handle = entity_store_.find(name);
+  if (
+    not handle or entity_update_histograms_.size() <= handle.get() or
+    entity_update_histograms_[handle.get()].count() == 0) {
+    THROW_SEMANTIC_ERROR("entity : ", name, " has never been updated.");
+  }
+  return entity_update_histograms_[handle.get()];
+}
+
 auto EntityManager::getEntityTypeList() const
   -> const std::unordered_map<std::string, traffic_simulator_msgs::msg::EntityType>
 {
   std::unordered_map<std::string, traffic_simulator_msgs::msg::EntityType> ret;
-  for (auto it = entities_.begin(); it != entities_.end(); it++) {
-    ret.emplace(it->first, it->second->getEntityType());
+  for (EntityStore::Handle handle = 0; handle < entity_store_.size(); ++handle) {
+    ret.emplace(entity_store_.name(handle), entity_store_.entity(handle)->getEntityType());
   }
   return ret;
 }
@@ -205,6 +254,32 @@ auto EntityManager::getHdmapUtils() -> const std::shared_ptr<hdmap_utils::HdMapU
   return hdmap_utils_ptr_;
 }
 
+auto EntityManager::getLevelOfDetail(const std::string & name) const -> LevelOfDetail
+{
+  const auto handle = entity_store_.find(name);
+  return handle ? level_of_detail_scheduler_.getLevelOfDetail(handle.get()) : LevelOfDetail::FULL;
+}
+
+auto EntityManager::getLevelOfDetailReferencePositions() const
+  -> std::vector<geometry_msgs::msg::Point>
+{
+  std::vector<geometry_msgs::msg::Point> positions;
+  for (EntityStore::Handle handle = 0; handle < entity_store_.size(); ++handle) {
+    if (
+      entity_store_.status_set()[handle] and
+      entity_store_.entity(handle)->getEntityType().type ==
+        traffic_simulator_msgs::msg::EntityType::EGO) {
+      positions.push_back(entity_store_.poses()[handle].position);
+    }
+  }
+  return positions;
+}
+
+auto EntityManager::getLevelOfDetailStatistics() const noexcept -> const LevelOfDetailStatistics &
+{
+  return level_of_detail_scheduler_.getStatistics();
+}
+
 auto EntityManager::getLaneletPose(const std::string & name)
   -> boost::optional<traffic_simulator_msgs::msg::LaneletPose>
 {
@@ -354,8 +429,9 @@ geometry_msgs::msg::Pose EntityManager::getMapPose(
 
 auto EntityManager::getNumberOfEgo() const -> std::size_t
 {
-  return std::count_if(std::begin(entities_), std::end(entities_), [this](const auto & each) {
-    return isEgo(each.first);
+  const auto & names = entity_store_.names();
+  return std::count_if(std::begin(names), std::end(names), [this](const auto & each) {
+    return isEgo(each);
   });
 }
 
@@ -378,7 +454,7 @@ auto EntityManager::getObstacle(const std::string & name)
   if (current_time_ < 0) {
     return boost::none;
   }
-  return entities_.at(name)->getObstacle();
+  return entity_store_.entity(name)->getObstacle();
 }
 
 auto EntityManager::getRelativePose(
@@ -424,13 +500,37 @@ auto EntityManager::getRelativePose(const std::string & from, const std::string
 
 auto EntityManager::getStepTime() const noexcept -> double { return step_time_; }
 
+auto EntityManager::getUpdateCostReport() const -> nlohmann::json
+{
+  nlohmann::json report;
+  report["frame"] = frame_update_histogram_.toJson();
+  report["entities"] = nlohmann::json::object();
+  for (EntityStore::Handle handle = 0; handle < entity_update_histograms_.size(); ++handle) {
+    if (entity_update_histograms_[handle].count() != 0) {
+      report["entities"][entity_store_.name(handle)] = entity_update_histograms_[handle].toJson();
+    }
+  }
+  report["despawned_entities"] = nlohmann::json::object();
+  for (const auto & histogram : despawned_entity_update_histograms_) {
+    report["despawned_entities"][histogram.first] = histogram.second.toJson();
+  }
+  report["behavior_plugins"] = nlohmann::json::object();
+  for (const auto & histogram : behavior_plugin_update_histograms_) {
+    report["behavior_plugins"][histogram.first] = histogram.second.toJson();
+  }
+  if (entity_behavior::BehaviorTreeProfiler::get().enabled()) {
+    report["behavior_trees"] = entity_behavior::BehaviorTreeProfiler::get().toJson();
+  }
+  return report;
+}
+
 auto EntityManager::getWaypoints(const std::string & name)
   -> traffic_simulator_msgs::msg::WaypointsArray
 {
   if (current_time_ < 0) {
     return traffic_simulator_msgs::msg::WaypointsArray();
   }
-  return entities_.at(name)->getWaypoints();
+  return entity_store_.entity(name)->getWaypoints();
 }
 
 void EntityManager::getGoalPoses(
@@ -439,7 +539,7 @@ void EntityManager::getGoalPoses(
   if (current_time_ < 0) {
     goals = std::vector<traffic_simulator_msgs::msg::LaneletPose>();
   }
-  goals = entities_.at(name)->getGoalPoses();
+  goals = entity_store_.entity(name)->getGoalPoses();
 }
 
 void EntityManager::getGoalPoses(
@@ -546,6 +646,98 @@ bool EntityManager::reachPosition(
   return reachPosition(name, target_pose.pose, tolerance);
 }
 
+void EntityManager::publishEntityStatusArray(
+  const std::unordered_map<std::string, traffic_simulator_msgs::msg::EntityStatus> & all_status)
+{
+  /**
+   * @note get_subscription_count already includes the intra-process subscriptions.
+   */
+  const auto subscription_count = entity_status_array_pub_ptr_->get_subscription_count();
+  if (subscription_count > entity_status_subscription_count_) {
+    /**
+     * @note Subscribers joined after the last publication have not received the trajectories
+     * omitted in compact form yet, so send all of them again.
+     */
+    published_trajectories_.clear();
+  }
+  entity_status_subscription_count_ = subscription_count;
+  if (subscription_count == 0) {
+    return;
+  }
+  if (
+    last_entity_status_publish_time_ and configuration.entity_status_publish_rate > 0 and
+    current_time_ - last_entity_status_publish_time_.get() <
+      1.0 / configuration.entity_status_publish_rate - step_time_ * 0.5) {
+    return;
+  }
+  last_entity_status_publish_time_ = current_time_;
+  traffic_simulator_msgs::msg::EntityStatusWithTrajectoryArray status_array_msg;
+  std::unordered_map<std::string, traffic_simulator_msgs::msg::EntityStatusWithTrajectory>
+    trajectories;
+  for (const auto & status : all_status) {
+    traffic_simulator_msgs::msg::EntityStatusWithTrajectory status_with_traj;
+    auto status_msg = status.second;
+    status_msg.name = status.first;
+    status_msg.bounding_box = getBoundingBox(status.first);
+    status_msg.action_status.current_action = getCurrentAction(status.first);
+    switch (getEntityType(status.first).type) {
+      case traffic_simulator_msgs::msg::EntityType::EGO:
+        status_msg.type.type = status_msg.type.EGO;
+        break;
+      case traffic_simulator_msgs::msg::EntityType::VEHICLE:
+        status_msg.type.type = status_msg.type.VEHICLE;
+        break;
+      case traffic_simulator_msgs::msg::EntityType::PEDESTRIAN:
+        status_msg.type.type = status_msg.type.PEDESTRIAN;
+        break;
+    }
+    auto waypoint = getWaypoints(status.first);
+    std::vector<geometry_msgs::msg::Pose> goal_pose;
+    getGoalPoses(status.first, goal_pose);
+    const auto obstacle = getObstacle(status.first);
+    status_with_traj.name = status.first;
+    status_with_traj.time = current_time_ + step_time_;
+    /**
+     * @note Compare the trajectory with the published one before copying it into the message, so
+     * that an unchanged trajectory is never copied.
+     */
+    const auto published = configuration.compact_entity_status
+                             ? published_trajectories_.find(status.first)
+                             : std::end(published_trajectories_);
+    if (
+      published != std::end(published_trajectories_) and
+      published->second.waypoint == waypoint and published->second.goal_pose == goal_pose and
+      published->second.obstacle_find == static_cast<bool>(obstacle) and
+      (not obstacle or published->second.obstacle == obstacle.get())) {
+      trajectories.emplace(status.first, std::move(published->second));
+      status_with_traj.trajectory_updated = false;
+    } else {
+      status_with_traj.waypoint = std::move(waypoint);
+      status_with_traj.goal_pose = std::move(goal_pose);
+      if (obstacle) {
+        status_with_traj.obstacle = obstacle.get();
+        status_with_traj.obstacle_find = true;
+      } else {
+        status_with_traj.obstacle_find = false;
+      }
+      if (configuration.compact_entity_status) {
+        trajectories.emplace(status.first, status_with_traj);
+      }
+    }
+    status_with_traj.status = std::move(status_msg);
+    status_array_msg.data.emplace_back(std::move(status_with_traj));
+  }
+  published_trajectories_ = std::move(trajectories);
+  entity_status_array_pub_ptr_->publish(status_array_msg);
+}
+
+void EntityManager::requestBehaviorUpdate(const std::string & name)
+{
+  if (const auto handle = entity_store_.find(name)) {
+    level_of_detail_scheduler_.requestBehaviorUpdate(handle.get());
+  }
+}
+
 void EntityManager::requestLaneChange(
   const std::string & name, const traffic_simulator::lane_change::Direction & direction)
 {
@@ -571,7 +763,8 @@ void EntityManager::requestSpeedChange(
   if (isEgo(name) && getCurrentTime() > 0) {
     THROW_SEMANTIC_ERROR("You cannot set target speed to the ego vehicle after starting scenario.");
   }
-  return entities_.at(name)->requestSpeedChange(target_speed, continuous);
+  requestBehaviorUpdate(name);
+  return entity_store_.entity(name)->requestSpeedChange(target_speed, continuous);
 }
 
 void EntityManager::requestSpeedChange(
@@ -581,7 +774,9 @@ void EntityManager::requestSpeedChange(
   if (isEgo(name) && getCurrentTime() > 0) {
     THROW_SEMANTIC_ERROR("You cannot set target speed to the ego vehicle after starting scenario.");
   }
-  return entities_.at(name)->requestSpeedChange(target_speed, transition, constraint, continuous);
+  requestBehaviorUpdate(name);
+  return entity_store_.entity(name)->requestSpeedChange(
+    target_speed, transition, constraint, continuous);
 }
 
 void EntityManager::requestSpeedChange(
@@ -590,7 +785,8 @@ void EntityManager::requestSpeedChange(
   if (isEgo(name) && getCurrentTime() > 0) {
     THROW_SEMANTIC_ERROR("You cannot set target speed to the ego vehicle after starting scenario.");
   }
-  return entities_.at(name)->requestSpeedChange(target_speed, continuous);
+  requestBehaviorUpdate(name);
+  return entity_store_.entity(name)->requestSpeedChange(target_speed, continuous);
 }
 
 void EntityManager::requestSpeedChange(
@@ -601,7 +797,9 @@ void EntityManager::requestSpeedChange(
   if (isEgo(name) && getCurrentTime() > 0) {
     THROW_SEMANTIC_ERROR("You cannot set target speed to the ego vehicle after starting scenario.");
   }
-  return entities_.at(name)->requestSpeedChange(target_speed, transition, constraint, continuous);
+  requestBehaviorUpdate(name);
+  return entity_store_.entity(name)->requestSpeedChange(
+    target_speed, transition, constraint, continuous);
 }
 
 bool EntityManager::setEntityStatus(
@@ -612,14 +810,21 @@ bool EntityManager::setEntityStatus(
     THROW_SEMANTIC_ERROR(
       "You cannot set entity status to the ego vehicle name:", name, " after starting scenario.");
   }
-  return entities_.at(name)->setStatus(status);
+  const auto entity = entity_store_.entity(name);
+  const auto result = entity->setStatus(status);
+  if (entity->statusSet()) {
+    auto stored_status = entity->getStatus();
+    stored_status.bounding_box = getBoundingBox(name);
+    entity_store_.update(getEntityHandle(name), stored_status);
+  }
+  return result;
 }
 
 void EntityManager::setVerbose(const bool verbose)
 {
   configuration.verbose = verbose;
-  for (auto & entity : entities_) {
-    entity.second->setVerbose(verbose);
+  for (const auto & entity : entity_store_.entities()) {
+    entity->setVerbose(verbose);
   }
 }
 
@@ -632,22 +837,69 @@ auto EntityManager::toMapPose(const traffic_simulator_msgs::msg::LaneletPose & l
 traffic_simulator_msgs::msg::EntityStatus EntityManager::updateNpcLogic(
   const std::string & name,
   const std::unordered_map<std::string, traffic_simulator_msgs::msg::EntityType> & type_list)
+{
+  const auto handle = getEntityHandle(name);
+  entity_store_.entity(handle)->setEntityTypeList(
+    std::make_shared<const entity_behavior::BehaviorPluginBase::EntityTypeDict>(type_list));
+  return updateNpcLogic(handle);
+}
+
+traffic_simulator_msgs::msg::EntityStatus EntityManager::updateNpcLogic(
+  const EntityStore::Handle handle)
 {
   if (configuration.verbose) {
-    std::cout << "update " << name << " behavior" << std::endl;
+    std::cout << "update " << entity_store_.name(handle) << " behavior" << std::endl;
   }
-  entities_[name]->setEntityTypeList(type_list);
-  entities_[name]->onUpdate(current_time_, step_time_);
-  if (entities_[name]->statusSet()) {
-    return entities_[name]->getStatus();
+  const auto entity = entity_store_.entity(handle);
+  entity->onUpdate(current_time_, step_time_);
+  if (entity->statusSet()) {
+    return entity->getStatus();
+  }
+  THROW_SIMULATION_ERROR("status of entity ", entity_store_.name(handle), "is empty");
+}
+
+traffic_simulator_msgs::msg::EntityStatus EntityManager::updateNpcLogicKinematically(
+  const std::string & name)
+{
+  return updateNpcLogicKinematically(getEntityHandle(name));
+}
+
+traffic_simulator_msgs::msg::EntityStatus EntityManager::updateNpcLogicKinematically(
+  const EntityStore::Handle handle)
+{
+  if (configuration.verbose) {
+    std::cout << "update " << entity_store_.name(handle) << " kinematically" << std::endl;
+  }
+  const auto entity = entity_store_.entity(handle);
+  entity->onKinematicUpdate(current_time_, step_time_);
+  if (entity->statusSet()) {
+    return entity->getStatus();
+  }
+  THROW_SIMULATION_ERROR("status of entity ", entity_store_.name(handle), "is empty");
+}
+
+void EntityManager::updateNpcLogicInBatch(
+  const std::vector<EntityStore::Handle> & handles,
+  const entity_behavior::BehaviorPluginBase::WorldSnapshot & world)
+{
+  std::vector<entity_behavior::BehaviorPluginBase *> plugins;
+  for (const auto handle : handles) {
+    if (configuration.verbose) {
+      std::cout << "update " << entity_store_.name(handle) << " behavior in batch" << std::endl;
+    }
+    const auto entity = entity_store_.entity(handle);
+    entity->onPreBatchUpdate(current_time_, step_time_);
+    plugins.push_back(entity->getBatchBehaviorPlugin());
+  }
+  plugins.front()->updateBatch(plugins, world);
+  for (const auto handle : handles) {
+    entity_store_.entity(handle)->onPostBatchUpdate(current_time_, step_time_);
   }
-  THROW_SIMULATION_ERROR("status of entity ", name, "is empty");
 }
 
 void EntityManager::update(const double current_time, const double step_time)
 {
-  std::chrono::system_clock::time_point start, end;
-  start = std::chrono::system_clock::now();
+  const auto start = std::chrono::steady_clock::now();
   step_time_ = step_time;
   current_time_ = current_time;
   if (configuration.verbose) {
@@ -661,70 +913,101 @@ void EntityManager::update(const double current_time, const double step_time)
     traffic_light_manager_ptr_->update(step_time_);
   }
   setVerbose(configuration.verbose);
-  auto type_list = getEntityTypeList();
+  const auto type_list =
+    std::make_shared<const entity_behavior::BehaviorPluginBase::EntityTypeDict>(
+      getEntityTypeList());
   std::unordered_map<std::string, traffic_simulator_msgs::msg::EntityStatus> all_status;
-  const std::vector<std::string> entity_names = getEntityNames();
-  for (const auto & entity_name : entity_names) {
-    if (entities_[entity_name]->statusSet()) {
-      all_status.emplace(entity_name, entities_[entity_name]->getStatus());
+  for (EntityStore::Handle handle = 0; handle < entity_store_.size(); ++handle) {
+    if (entity_store_.entity(handle)->statusSet()) {
+      all_status.emplace(entity_store_.name(handle), entity_store_.entity(handle)->getStatus());
     }
   }
-  for (auto it = entities_.begin(); it != entities_.end(); it++) {
-    it->second->setOtherStatus(all_status);
-  }
-  all_status.clear();
-  for (const auto & entity_name : entity_names) {
-    if (entities_[entity_name]->statusSet()) {
-      auto status = updateNpcLogic(entity_name, type_list);
-      status.bounding_box = getBoundingBox(entity_name);
-      all_status.emplace(entity_name, status);
+  const auto entity_status =
+    std::make_shared<const entity_behavior::BehaviorPluginBase::EntityStatusDict>(
+      std::move(all_status));
+  // built once per frame and shared by every entity, instead of once per entity
+  const auto lanelet_entity_index =
+    std::make_shared<const entity_behavior::LaneletEntityIndex>(entity_status);
+  for (const auto & entity : entity_store_.entities()) {
+    entity->setOtherStatus(*lanelet_entity_index);
+    entity->setLaneletEntityIndex(lanelet_entity_index);
+    entity->setEntityTypeList(type_list);
+  }
+  const entity_behavior::BehaviorPluginBase::WorldSnapshot world{
+    current_time_, step_time_, entity_status, type_list, lanelet_entity_index};
+  // updated statuses of this frame, indexed by entity handle
+  std::vector<boost::optional<traffic_simulator_msgs::msg::EntityStatus>> updated_status(
+    entity_store_.size());
+  const auto commit = [&](const EntityStore::Handle handle,
+                          traffic_simulator_msgs::msg::EntityStatus status) {
+    status.bounding_box = entity_store_.bounding_boxes()[handle];
+    entity_store_.update(handle, status);
+    updated_status[handle] = std::move(status);
+  };
+  entity_update_histograms_.resize(entity_store_.size());
+  std::map<std::string, std::vector<EntityStore::Handle>> batches;
+  level_of_detail_scheduler_.beginFrame(getLevelOfDetailReferencePositions());
+  for (EntityStore::Handle handle = 0; handle < entity_store_.size(); ++handle) {
+    if (entity_store_.entity(handle)->statusSet()) {
+      const auto update_behavior =
+        level_of_detail_scheduler_.schedule(handle, entity_store_.poses()[handle].position);
+      if (
+        update_behavior and current_time_ >= 0 and
+        entity_store_.entity(handle)->getBatchBehaviorPlugin()) {
+        batches[entity_store_.entity(handle)->getBehaviorPluginName()].push_back(handle);
+        continue;
+      }
+      const auto update_start = std::chrono::steady_clock::now();
+      auto status =
+        update_behavior ? updateNpcLogic(handle) : updateNpcLogicKinematically(handle);
+      const auto update_duration = std::chrono::steady_clock::now() - update_start;
+      entity_update_histograms_[handle].add(update_duration);
+      if (update_behavior) {
+        behavior_plugin_update_histograms_[entity_store_.entity(handle)->getBehaviorPluginName()]
+          .add(update_duration);
+      }
+      commit(handle, std::move(status));
     }
   }
-  for (auto it = entities_.begin(); it != entities_.end(); it++) {
-    it->second->setOtherStatus(all_status);
-  }
-  auto entity_type_list = getEntityTypeList();
-  traffic_simulator_msgs::msg::EntityStatusWithTrajectoryArray status_array_msg;
-  for (const auto & status : all_status) {
-    traffic_simulator_msgs::msg::EntityStatusWithTrajectory status_with_traj;
-    auto status_msg = status.second;
-    status_msg.name = status.first;
-    status_msg.bounding_box = getBoundingBox(status.first);
-    status_msg.action_status.current_action = getCurrentAction(status.first);
-    switch (getEntityType(status.first).type) {
-      case traffic_simulator_msgs::msg::EntityType::EGO:
-        status_msg.type.type = status_msg.type.EGO;
-        break;
-      case traffic_simulator_msgs::msg::EntityType::VEHICLE:
-        status_msg.type.type = status_msg.type.VEHICLE;
-        break;
-      case traffic_simulator_msgs::msg::EntityType::PEDESTRIAN:
-        status_msg.type.type = status_msg.type.PEDESTRIAN;
-        break;
-    }
-    status_with_traj.waypoint = getWaypoints(status.first);
-    std::vector<geometry_msgs::msg::Pose> goals;
-    getGoalPoses(status.first, goals);
-    for (const auto goal : goals) {
-      status_with_traj.goal_pose.push_back(goal);
+  /**
+   * @note Batches are updated after all the other entities, in the order of behavior plugin
+   * names. Each entity of a batch is charged an equal share of the update time of the batch.
+   */
+  for (const auto & batch : batches) {
+    const auto update_start = std::chrono::steady_clock::now();
+    updateNpcLogicInBatch(batch.second, world);
+    const auto update_duration = std::chrono::steady_clock::now() - update_start;
+    behavior_plugin_update_histograms_[batch.first].add(update_duration);
+    const auto update_duration_per_entity =
+      update_duration / static_cast<std::int64_t>(batch.second.size());
+    for (const auto handle : batch.second) {
+      entity_update_histograms_[handle].add(update_duration_per_entity);
+      commit(handle, entity_store_.entity(handle)->getStatus());
     }
-    const auto obstacle = getObstacle(status.first);
-    if (obstacle) {
-      status_with_traj.obstacle = obstacle.get();
-      status_with_traj.obstacle_find = true;
-    } else {
-      status_with_traj.obstacle_find = false;
+  }
+  all_status.clear();
+  for (EntityStore::Handle handle = 0; handle < entity_store_.size(); ++handle) {
+    if (updated_status[handle]) {
+      all_status.emplace(entity_store_.name(handle), std::move(updated_status[handle].get()));
     }
-    status_with_traj.status = status_msg;
-    status_with_traj.name = status.first;
-    status_with_traj.time = current_time + step_time;
-    status_array_msg.data.emplace_back(status_with_traj);
   }
-  entity_status_array_pub_ptr_->publish(status_array_msg);
-  end = std::chrono::system_clock::now();
-  double elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
+  const auto updated_entity_status =
+    std::make_shared<const entity_behavior::BehaviorPluginBase::EntityStatusDict>(
+      std::move(all_status));
+  const entity_behavior::LaneletEntityIndex updated_lanelet_entity_index(updated_entity_status);
+  for (const auto & entity : entity_store_.entities()) {
+    entity->setOtherStatus(updated_lanelet_entity_index);
+  }
+  publishEntityStatusArray(*updated_entity_status);
+  const auto duration = std::chrono::steady_clock::now() - start;
+  frame_update_histogram_.add(duration);
+  double elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(duration).count();
   if (configuration.verbose) {
     std::cout << "elapsed " << elapsed / 1000 << " seconds in update function." << std::endl;
+    if (level_of_detail_scheduler_.enabled()) {
+      std::cout << "level of detail : " << level_of_detail_scheduler_.getStatistics()
+                << std::endl;
+    }
   }
 }
 
@@ -739,5 +1022,13 @@ void EntityManager::updateHdmapMarker()
   }
   lanelet_marker_pub_ptr_->publish(markers);
 }
+
+auto EntityManager::writeUpdateCostLog() const -> void
+{
+  if (not configuration.update_cost_log_path.empty()) {
+    std::ofstream file(configuration.update_cost_log_path.string());
+    file << getUpdateCostReport().dump(2) << std::endl;
+  }
+}
 }  // namespace entity
 }  // namespace traffic_simulator
@@ -0,0 +1,124 @@
+// Copyright 2015-2020 Tier IV, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <scenario_simulator_exception/exception.hpp>
+#include <string>
+#include <traffic_simulator/entity/entity_store.hpp>
+#include <utility>
+
+namespace traffic_simulator
+{
+namespace entity
+{
+auto EntityStore::add(
+  const std::string & name, std::unique_ptr<EntityBase> entity,
+  const traffic_simulator_msgs::msg::BoundingBox & bounding_box) -> Handle
+{
+  if (contains(name)) {
+    THROW_SEMANTIC_ERROR("entity : ", name, " is already exists.");
+  }
+  const Handle handle = names_.size();
+  handles_.emplace(name, handle);
+  names_.push_back(name);
+  entities_.push_back(std::move(entity));
+  status_set_.push_back(false);
+  poses_.emplace_back();
+  twists_.emplace_back();
+  accels_.emplace_back();
+  bounding_boxes_.push_back(bounding_box);
+  lanelet_poses_.emplace_back();
+  lanelet_pose_valid_.push_back(false);
+  return handle;
+}
+
+void EntityStore::clear()
+{
+  handles_.clear();
+  names_.clear();
+  entities_.clear();
+  status_set_.clear();
+  poses_.clear();
+  twists_.clear();
+  accels_.clear();
+  bounding_boxes_.clear();
+  lanelet_poses_.clear();
+  lanelet_pose_valid_.clear();
+}
+
+auto EntityStore::contains(const std::string & name) const -> bool
+{
+  return handles_.find(name) != std::end(handles_);
+}
+
+auto EntityStore::entity(const std::string & name) const -> EntityBase *
+{
+  return entities_[handle(name)].get();
+}
+
+auto EntityStore::find(const std::string & name) const -> boost::optional<Handle>
+{
+  const auto iter = handles_.find(name);
+  if (iter == std::end(handles_)) {
+    return boost::none;
+  }
+  return iter->second;
+}
+
+auto EntityStore::handle(const std::string & name) const -> Handle
+{
+  const auto iter = handles_.find(name);
+  if (iter == std::end(handles_)) {
+    THROW_SEMANTIC_ERROR("entity : ", name, " does not exist.");
+  }
+  return iter->second;
+}
+
+auto EntityStore::remove(const std::string & name) -> bool
+{
+  const auto iter = handles_.find(name);
+  if (iter == std::end(handles_)) {
+    return false;
+  }
+  const auto removed = iter->second;
+  handles_.erase(iter);
+  for (auto & each : handles_) {
+    if (removed < each.second) {
+      --each.second;
+    }
+  }
+  names_.erase(names_.begin() + removed);
+  entities_.erase(entities_.begin() + removed);
+  status_set_.erase(status_set_.begin() + removed);
+  poses_.erase(poses_.begin() + removed);
+  twists_.erase(twists_.begin() + removed);
+  accels_.erase(accels_.begin() + removed);
+  bounding_boxes_.erase(bounding_boxes_.begin() + removed);
+  lanelet_poses_.erase(lanelet_poses_.begin() + removed);
+  lanelet_pose_valid_.erase(lanelet_pose_valid_.begin() + removed);
+  return true;
+}
+
+void EntityStore::update(
+  const Handle handle, const traffic_simulator_msgs::msg::EntityStatus & status)
+{
+  status_set_.at(handle) = true;
+  poses_[handle] = status.pose;
+  twists_[handle] = status.action_status.twist;
+  accels_[handle] = status.action_status.accel;
+  bounding_boxes_[handle] = status.bounding_box;
+  lanelet_poses_[handle] = status.lanelet_pose;
+  lanelet_pose_valid_[handle] = status.lanelet_pose_valid;
+}
+}  // namespace entity
+}  // namespace traffic_simulator
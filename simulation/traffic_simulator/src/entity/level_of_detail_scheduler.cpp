@@ -0,0 +1,155 @@
+// Copyright 2015-2020 Tier IV, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <traffic_simulator/entity/level_of_detail_scheduler.hpp>
+#include <vector>
+
+namespace traffic_simulator
+{
+namespace entity
+{
+auto operator<<(std::ostream & os, const LevelOfDetail & level_of_detail) -> std::ostream &
+{
+  switch (level_of_detail) {
+    case LevelOfDetail::FULL:
+      return os << "full";
+    case LevelOfDetail::REDUCED:
+      return os << "reduced";
+    case LevelOfDetail::KINEMATIC:
+      return os << "kinematic";
+    default:
+      return os;
+  }
+}
+
+auto operator<<(std::ostream & os, const LevelOfDetailStatistics & statistics) -> std::ostream &
+{
+  return os << "full : " << statistics.full << ", reduced : " << statistics.reduced
+            << ", kinematic : " << statistics.kinematic
+            << ", behavior updates : " << statistics.behavior_updates;
+}
+
+LevelOfDetailScheduler::LevelOfDetailScheduler(
+  const double full_radius, const double reduced_radius, const std::size_t reduced_interval)
+: full_radius_(full_radius),
+  reduced_radius_(std::max(full_radius, reduced_radius)),
+  reduced_interval_(std::max<std::size_t>(reduced_interval, 1))
+{
+}
+
+void LevelOfDetailScheduler::beginFrame(
+  const std::vector<geometry_msgs::msg::Point> & reference_positions)
+{
+  reference_positions_ = reference_positions;
+  statistics_ = LevelOfDetailStatistics();
+}
+
+auto LevelOfDetailScheduler::classify(const geometry_msgs::msg::Point & position) const
+  -> LevelOfDetail
+{
+  if (not enabled() or reference_positions_.empty()) {
+    return LevelOfDetail::FULL;
+  }
+  double squared_distance = std::numeric_limits<double>::max();
+  for (const auto & reference : reference_positions_) {
+    squared_distance = std::min(
+      squared_distance, std::pow(position.x - reference.x, 2) +
+                          std::pow(position.y - reference.y, 2) +
+                          std::pow(position.z - reference.z, 2));
+  }
+  if (squared_distance <= full_radius_ * full_radius_) {
+    return LevelOfDetail::FULL;
+  } else if (squared_distance <= reduced_radius_ * reduced_radius_) {
+    return LevelOfDetail::REDUCED;
+  } else {
+    return LevelOfDetail::KINEMATIC;
+  }
+}
+
+auto LevelOfDetailScheduler::schedule(
+  const std::size_t handle, const geometry_msgs::msg::Point & position) -> bool
+{
+  const auto level_of_detail = classify(position);
+  if (states_.size() <= handle) {
+    states_.resize(handle + 1);
+  }
+  auto & state = states_[handle];
+  /**
+   * @note Newly scheduled entities and entities whose request changed evaluate their behavior at
+   * once. Such an extra update does not reset the interval of reduced entities, so that the
+   * staggered phases are kept.
+   */
+  const bool extra_update = not state.scheduled or state.behavior_update_requested;
+  if (not state.scheduled) {
+    /**
+     * @note Stagger the phase of newly scheduled entities in the order of scheduling, so that
+     * entities spawned together do not evaluate their behavior in the same frame.
+     */
+    state = State{true, level_of_detail, scheduled_entities_++ % reduced_interval_};
+  }
+  bool update_behavior = false;
+  switch (level_of_detail) {
+    case LevelOfDetail::FULL:
+      statistics_.full++;
+      update_behavior = true;
+      break;
+    case LevelOfDetail::REDUCED:
+      statistics_.reduced++;
+      // entities promoted from kinematic level are updated at once
+      update_behavior = state.level_of_detail == LevelOfDetail::KINEMATIC or
+                        state.skipped_frames + 1 >= reduced_interval_;
+      break;
+    case LevelOfDetail::KINEMATIC:
+      statistics_.kinematic++;
+      break;
+  }
+  state.level_of_detail = level_of_detail;
+  state.behavior_update_requested = false;
+  if (update_behavior) {
+    state.skipped_frames = 0;
+  } else {
+    state.skipped_frames++;
+  }
+  if (update_behavior or extra_update) {
+    statistics_.behavior_updates++;
+    return true;
+  } else {
+    return false;
+  }
+}
+
+void LevelOfDetailScheduler::requestBehaviorUpdate(const std::size_t handle)
+{
+  if (states_.size() <= handle) {
+    states_.resize(handle + 1);
+  }
+  states_[handle].behavior_update_requested = true;
+}
+
+void LevelOfDetailScheduler::remove(const std::size_t handle)
+{
+  if (handle < states_.size()) {
+    states_.erase(states_.begin() + handle);
+  }
+}
+
+auto LevelOfDetailScheduler::getLevelOfDetail(const std::size_t handle) const -> LevelOfDetail
+{
+  return handle < states_.size() ? states_[handle].level_of_detail : LevelOfDetail::FULL;
+}
+}  // namespace entity
+}  // namespace traffic_simulator
@@ -30,9 +30,8 @@ PedestrianEntity::PedestrianEntity(
 : EntityBase(params.pedestrian_category, name),
   parameters(params),
   plugin_name(plugin_name),
-  loader_(pluginlib::ClassLoader<entity_behavior::BehaviorPluginBase>(
-    "traffic_simulator", "entity_behavior::BehaviorPluginBase")),
-  behavior_plugin_ptr_(loader_.createSharedInstance(plugin_name))
+  behavior_plugin_ptr_(
+    entity_behavior::BehaviorPluginLoader::get().createSharedInstance(plugin_name))
 {
   entity_type_.type = traffic_simulator_msgs::msg::EntityType::PEDESTRIAN;
   behavior_plugin_ptr_->configure(rclcpp::get_logger(name));
@@ -155,39 +154,63 @@ void PedestrianEntity::onUpdate(double current_time, double step_time)
   if (current_time < 0) {
     updateEntityStatusTimestamp(current_time);
   } else {
-    behavior_plugin_ptr_->setOtherEntityStatus(other_status_);
-    behavior_plugin_ptr_->setEntityTypeList(entity_type_list_);
-    behavior_plugin_ptr_->setEntityStatus(status_.get());
-    target_speed_planner_.update(status_->action_status.twist.linear.x, other_status_);
-    behavior_plugin_ptr_->setTargetSpeed(target_speed_planner_.getTargetSpeed());
-    if (status_->lanelet_pose_valid) {
-      auto route = route_planner_ptr_->getRouteLanelets(status_->lanelet_pose);
-      behavior_plugin_ptr_->setRouteLanelets(route);
-    } else {
-      std::vector<std::int64_t> empty = {};
-      behavior_plugin_ptr_->setRouteLanelets(empty);
-    }
+    prepareBehaviorPluginUpdate();
     behavior_plugin_ptr_->update(current_time, step_time);
-    auto status_updated = behavior_plugin_ptr_->getUpdatedStatus();
-    if (status_updated.lanelet_pose_valid) {
-      auto following_lanelets =
-        hdmap_utils_ptr_->getFollowingLanelets(status_updated.lanelet_pose.lanelet_id);
-      auto l = hdmap_utils_ptr_->getLaneletLength(status_updated.lanelet_pose.lanelet_id);
-      if (following_lanelets.size() == 1 && l <= status_updated.lanelet_pose.s) {
-        stopAtEndOfRoad();
-        return;
-      }
-    }
-    if (!status_) {
-      linear_jerk_ = 0;
-    } else {
-      linear_jerk_ =
-        (status_updated.action_status.accel.linear.x - status_->action_status.accel.linear.x) /
-        step_time;
+    applyBehaviorPluginUpdate(step_time);
+  }
+}
+
+void PedestrianEntity::onPreBatchUpdate(double current_time, double step_time)
+{
+  EntityBase::onUpdate(current_time, step_time);
+  prepareBehaviorPluginUpdate();
+}
+
+void PedestrianEntity::onPostBatchUpdate(double, double step_time)
+{
+  applyBehaviorPluginUpdate(step_time);
+}
+
+void PedestrianEntity::prepareBehaviorPluginUpdate()
+{
+  // The statuses of all entities the index was built from are shared with the plugin as they are.
+  behavior_plugin_ptr_->setOtherEntityStatus(
+    lanelet_entity_index_ ? lanelet_entity_index_->getEntityStatusDict() : nullptr);
+  behavior_plugin_ptr_->setLaneletEntityIndex(lanelet_entity_index_);
+  behavior_plugin_ptr_->setEntityTypeList(entity_type_list_);
+  behavior_plugin_ptr_->setEntityStatus(status_.get());
+  target_speed_planner_.update(status_->action_status.twist.linear.x, other_status_);
+  behavior_plugin_ptr_->setTargetSpeed(target_speed_planner_.getTargetSpeed());
+  if (status_->lanelet_pose_valid) {
+    auto route = route_planner_ptr_->getRouteLanelets(status_->lanelet_pose);
+    behavior_plugin_ptr_->setRouteLanelets(route);
+  } else {
+    std::vector<std::int64_t> empty = {};
+    behavior_plugin_ptr_->setRouteLanelets(empty);
+  }
+}
+
+void PedestrianEntity::applyBehaviorPluginUpdate(double step_time)
+{
+  auto status_updated = behavior_plugin_ptr_->getUpdatedStatus();
+  if (status_updated.lanelet_pose_valid) {
+    auto following_lanelets =
+      hdmap_utils_ptr_->getFollowingLanelets(status_updated.lanelet_pose.lanelet_id);
+    auto l = hdmap_utils_ptr_->getLaneletLength(status_updated.lanelet_pose.lanelet_id);
+    if (following_lanelets.size() == 1 && l <= status_updated.lanelet_pose.s) {
+      stopAtEndOfRoad();
+      return;
     }
-    setStatus(status_updated);
-    updateStandStillDuration(step_time);
   }
+  if (!status_) {
+    linear_jerk_ = 0;
+  } else {
+    linear_jerk_ =
+      (status_updated.action_status.accel.linear.x - status_->action_status.accel.linear.x) /
+      step_time;
+  }
+  setStatus(status_updated);
+  updateStandStillDuration(step_time);
 }
 }  // namespace entity
 }  // namespace traffic_simulator
@@ -93,6 +93,9 @@ const std::vector<std::int64_t> HdMapUtils::getLaneletIds()
 
 const std::vector<geometry_msgs::msg::Point> HdMapUtils::getLaneletPolygon(std::int64_t lanelet_id)
 {
+  if (lanelet_polygon_cache_.exists(lanelet_id)) {
+    return lanelet_polygon_cache_.getPolygon(lanelet_id);
+  }
   std::vector<geometry_msgs::msg::Point> points;
   lanelet::CompoundPolygon3d lanelet_polygon =
     lanelet_map_ptr_->laneletLayer.get(lanelet_id).polygon3d();
@@ -103,9 +106,19 @@ const std::vector<geometry_msgs::msg::Point> HdMapUtils::getLaneletPolygon(std::
     p.z = lanelet_point.z();
     points.emplace_back(p);
   }
+  lanelet_polygon_cache_.appendData(lanelet_id, points);
   return points;
 }
 
+auto HdMapUtils::getLaneletPolygon2DBoundingBox(std::int64_t lanelet_id)
+  -> std::pair<geometry_msgs::msg::Point, geometry_msgs::msg::Point>
+{
+  if (!lanelet_polygon_cache_.exists(lanelet_id)) {
+    getLaneletPolygon(lanelet_id);
+  }
+  return lanelet_polygon_cache_.get2DBoundingBox(lanelet_id);
+}
+
 std::vector<std::int64_t> HdMapUtils::filterLaneletIds(
   const std::vector<std::int64_t> & lanelet_ids, const char subtype[]) const
 {
@@ -250,14 +263,22 @@ std::vector<std::int64_t> HdMapUtils::getConflictingCrosswalkIds(
   graphs.emplace_back(pedestrian_routing_graph_ptr_);
   lanelet::routing::RoutingGraphContainer container(graphs);
   for (const auto & lanelet_id : lanelet_ids) {
+    if (conflicting_crosswalk_cache_.exists(lanelet_id)) {
+      const auto ids = conflicting_crosswalk_cache_.getConflictingCrosswalkIds(lanelet_id);
+      ret.insert(ret.end(), ids.begin(), ids.end());
+      continue;
+    }
     const auto lanelet = lanelet_map_ptr_->laneletLayer.get(lanelet_id);
     double height_clearance = 4;
     size_t routing_graph_id = 1;
     const auto conflicting_crosswalks =
       container.conflictingInGraph(lanelet, routing_graph_id, height_clearance);
+    std::vector<std::int64_t> ids;
     for (const auto & crosswalk : conflicting_crosswalks) {
-      ret.emplace_back(crosswalk.id());
+      ids.emplace_back(crosswalk.id());
     }
+    conflicting_crosswalk_cache_.appendData(lanelet_id, ids);
+    ret.insert(ret.end(), ids.begin(), ids.end());
   }
   return ret;
 }
@@ -1348,6 +1369,24 @@ std::vector<lanelet::ConstLineString3d> HdMapUtils::getStopLinesOnPath(
   return ret;
 }
 
+std::vector<std::vector<geometry_msgs::msg::Point>> HdMapUtils::getStopLinesPointsOnPath(
+  const std::vector<std::int64_t> & lanelet_ids)
+{
+  std::vector<std::vector<geometry_msgs::msg::Point>> ret;
+  for (const auto & stop_line : getStopLinesOnPath(lanelet_ids)) {
+    std::vector<geometry_msgs::msg::Point> stop_line_points;
+    for (const auto & point : stop_line) {
+      geometry_msgs::msg::Point p;
+      p.x = point.x();
+      p.y = point.y();
+      p.z = point.z();
+      stop_line_points.emplace_back(p);
+    }
+    ret.emplace_back(stop_line_points);
+  }
+  return ret;
+}
+
 std::vector<lanelet::AutowareTrafficLightConstPtr> HdMapUtils::getTrafficLights(
   const std::int64_t traffic_light_id) const
 {
@@ -1488,16 +1527,7 @@ boost::optional<double> HdMapUtils::getDistanceToStopLine(
     return boost::none;
   }
   traffic_simulator::math::CatmullRomSpline spline(waypoints);
-  const auto stop_lines = getStopLinesOnPath({route_lanelets});
-  for (const auto & stop_line : stop_lines) {
-    std::vector<geometry_msgs::msg::Point> stop_line_points;
-    for (const auto & point : stop_line) {
-      geometry_msgs::msg::Point p;
-      p.x = point.x();
-      p.y = point.y();
-      p.z = point.z();
-      stop_line_points.emplace_back(p);
-    }
+  for (const auto & stop_line_points : getStopLinesPointsOnPath(route_lanelets)) {
     const auto collision_point = spline.getCollisionPointIn2D(stop_line_points);
     if (collision_point) {
       collision_points.insert(collision_point.get());
@@ -0,0 +1,97 @@
+// Copyright 2015-2020 Tier IV, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <traffic_simulator/helper/histogram.hpp>
+
+namespace traffic_simulator
+{
+namespace helper
+{
+constexpr std::size_t Histogram::number_of_buckets;
+
+void Histogram::add(const std::chrono::nanoseconds & duration)
+{
+  const auto microseconds = std::chrono::duration_cast<std::chrono::microseconds>(duration).count();
+  std::size_t index = 0;
+  while (index + 1 < number_of_buckets and (std::int64_t(1) << index) < microseconds) {
+    ++index;
+  }
+  buckets_[index]++;
+  count_++;
+  const auto seconds = std::chrono::duration<double>(duration).count();
+  sum_ = sum_ + seconds;
+  max_ = std::max(max_, seconds);
+}
+
+void Histogram::merge(const Histogram & other)
+{
+  for (std::size_t i = 0; i < number_of_buckets; ++i) {
+    buckets_[i] = buckets_[i] + other.buckets_[i];
+  }
+  count_ = count_ + other.count_;
+  sum_ = sum_ + other.sum_;
+  max_ = std::max(max_, other.max_);
+}
+
+auto Histogram::getUpperBound(const std::size_t bucket_index) -> double
+{
+  return std::ldexp(1.0, static_cast<int>(bucket_index)) * 1e-6;
+}
+
+auto Histogram::percentile(const double quantile) const -> double
+{
+  if (count_ == 0) {
+    return 0;
+  }
+  const auto rank =
+    static_cast<std::size_t>(std::ceil(std::min(std::max(quantile, 0.0), 1.0) * count_));
+  std::size_t accumulated = 0;
+  for (std::size_t i = 0; i < number_of_buckets; ++i) {
+    accumulated = accumulated + buckets_[i];
+    if (accumulated >= std::max<std::size_t>(rank, 1)) {
+      // the last bucket has no upper bound
+      return i + 1 < number_of_buckets ? std::min(getUpperBound(i), max_) : max_;
+    }
+  }
+  return max_;
+}
+
+auto Histogram::toJson() const -> nlohmann::json
+{
+  nlohmann::json json;
+  json["count"] = count_;
+  json["sum"] = sum_;
+  json["mean"] = mean();
+  json["max"] = max_;
+  json["p50"] = percentile(0.5);
+  json["p90"] = percentile(0.9);
+  json["p99"] = percentile(0.99);
+  nlohmann::json buckets = nlohmann::json::array();
+  for (std::size_t i = 0; i < number_of_buckets; ++i) {
+    if (buckets_[i] == 0) {
+      continue;
+    } else if (i + 1 < number_of_buckets) {
+      buckets.push_back({{"upper_bound", getUpperBound(i)}, {"count", buckets_[i]}});
+    } else {
+      buckets.push_back({{"upper_bound", nullptr}, {"count", buckets_[i]}});
+    }
+  }
+  json["buckets"] = buckets;
+  return json;
+}
+}  // namespace helper
+}  // namespace traffic_simulator
@@ -12,6 +12,7 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <algorithm>
 #include <iostream>
 #include <limits>
 #include <rclcpp/rclcpp.hpp>
@@ -315,6 +316,24 @@ boost::optional<double> CatmullRomSpline::getCollisionPointIn2D(
   return boost::none;
 }
 
+std::pair<geometry_msgs::msg::Point, geometry_msgs::msg::Point>
+CatmullRomSpline::get2DBoundingBox() const
+{
+  std::pair<geometry_msgs::msg::Point, geometry_msgs::msg::Point> bounding_box;
+  for (size_t i = 0; i < curves_.size(); i++) {
+    const auto curve_bounding_box = curves_[i].get2DBoundingBox();
+    if (i == 0) {
+      bounding_box = curve_bounding_box;
+      continue;
+    }
+    bounding_box.first.x = std::min(bounding_box.first.x, curve_bounding_box.first.x);
+    bounding_box.first.y = std::min(bounding_box.first.y, curve_bounding_box.first.y);
+    bounding_box.second.x = std::max(bounding_box.second.x, curve_bounding_box.second.x);
+    bounding_box.second.y = std::max(bounding_box.second.y, curve_bounding_box.second.y);
+  }
+  return bounding_box;
+}
+
 boost::optional<double> CatmullRomSpline::getSValue(
   const geometry_msgs::msg::Pose & pose, double threshold_distance)
 {
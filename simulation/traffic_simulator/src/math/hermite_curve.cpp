@@ -314,6 +314,26 @@ double HermiteCurve::getLength(size_t num_points) const
   return ret;
 }
 
+std::pair<geometry_msgs::msg::Point, geometry_msgs::msg::Point> HermiteCurve::get2DBoundingBox()
+  const
+{
+  const std::vector<std::pair<double, double>> control_points = {
+    {dx_, dy_},
+    {dx_ + cx_ / 3, dy_ + cy_ / 3},
+    {dx_ + 2 * cx_ / 3 + bx_ / 3, dy_ + 2 * cy_ / 3 + by_ / 3},
+    {ax_ + bx_ + cx_ + dx_, ay_ + by_ + cy_ + dy_}};
+  std::pair<geometry_msgs::msg::Point, geometry_msgs::msg::Point> bounding_box;
+  bounding_box.first.x = bounding_box.second.x = dx_;
+  bounding_box.first.y = bounding_box.second.y = dy_;
+  for (const auto & point : control_points) {
+    bounding_box.first.x = std::min(bounding_box.first.x, point.first);
+    bounding_box.first.y = std::min(bounding_box.first.y, point.second);
+    bounding_box.second.x = std::max(bounding_box.second.x, point.first);
+    bounding_box.second.y = std::max(bounding_box.second.y, point.second);
+  }
+  return bounding_box;
+}
+
 const geometry_msgs::msg::Point HermiteCurve::getPoint(double s, bool autoscale) const
 {
   if (autoscale) {
@@ -0,0 +1,98 @@
+// Copyright 2015-2020 Tier IV, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <traffic_simulator/behavior/lanelet_entity_index.hpp>
+#include <vector>
+
+auto makeEntityStatus(
+  const std::string & name, double x, double y, std::int64_t lanelet_id, bool lanelet_pose_valid)
+  -> traffic_simulator_msgs::msg::EntityStatus
+{
+  traffic_simulator_msgs::msg::EntityStatus status;
+  status.name = name;
+  status.pose.position.x = x;
+  status.pose.position.y = y;
+  status.lanelet_pose.lanelet_id = lanelet_id;
+  status.lanelet_pose_valid = lanelet_pose_valid;
+  return status;
+}
+
+auto makeLaneletEntityIndex() -> entity_behavior::LaneletEntityIndex
+{
+  auto entity_status = std::make_shared<entity_behavior::LaneletEntityIndex::EntityStatusDict>();
+  for (const auto & status :
+       {makeEntityStatus("ego", 0, 0, 34513, true), makeEntityStatus("near", 20, 10, 34513, true),
+        makeEntityStatus("far", 100, 0, 34510, true),
+        makeEntityStatus("stale", -10, 0, 34513, false)}) {
+    entity_status->emplace(status.name, status);
+  }
+  return entity_behavior::LaneletEntityIndex(entity_status);
+}
+
+auto getNames(const std::vector<const traffic_simulator_msgs::msg::EntityStatus *> & statuses)
+  -> std::vector<std::string>
+{
+  std::vector<std::string> names;
+  for (const auto status : statuses) {
+    names.emplace_back(status->name);
+  }
+  std::sort(names.begin(), names.end());
+  return names;
+}
+
+TEST(LANELET_ENTITY_INDEX, LANELET)
+{
+  const auto index = makeLaneletEntityIndex();
+  EXPECT_EQ(getNames(index.getEntityStatus(34513)), std::vector<std::string>({"ego", "near"}));
+  EXPECT_EQ(getNames(index.getEntityStatus(34510)), std::vector<std::string>({"far"}));
+  EXPECT_TRUE(index.empty(34468));
+  EXPECT_TRUE(index.getEntityStatus(34468).empty());
+}
+
+TEST(LANELET_ENTITY_INDEX, POSITION)
+{
+  const auto index = makeLaneletEntityIndex();
+  geometry_msgs::msg::Point position;
+  EXPECT_EQ(
+    getNames(index.getEntityStatus(position, 30)),
+    std::vector<std::string>({"ego", "near", "stale"}));
+  EXPECT_EQ(getNames(index.getEntityStatus(position, 10)), std::vector<std::string>({"ego"}));
+  EXPECT_EQ(
+    getNames(index.getEntityStatus(position, 1000)),
+    std::vector<std::string>({"ego", "far", "near", "stale"}));
+  position.x = 90;
+  EXPECT_EQ(getNames(index.getEntityStatus(position, 30)), std::vector<std::string>({"far"}));
+}
+
+TEST(LANELET_ENTITY_INDEX, MAX_BOUNDING_RADIUS)
+{
+  auto entity_status = std::make_shared<entity_behavior::LaneletEntityIndex::EntityStatusDict>();
+  auto status = makeEntityStatus("npc", 0, 0, 34513, true);
+  status.bounding_box.center.x = 1;
+  status.bounding_box.dimensions.x = 6;
+  status.bounding_box.dimensions.y = 8;
+  entity_status->emplace(status.name, status);
+  EXPECT_DOUBLE_EQ(entity_behavior::LaneletEntityIndex(entity_status).getMaxBoundingRadius(), 6);
+}
+
+int main(int argc, char ** argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
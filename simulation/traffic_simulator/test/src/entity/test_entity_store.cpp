@@ -0,0 +1,83 @@
+// Copyright 2015-2020 Tier IV, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <scenario_simulator_exception/exception.hpp>
+#include <traffic_simulator/entity/entity_store.hpp>
+#include <traffic_simulator/helper/helper.hpp>
+
+TEST(ENTITY_STORE, ADD)
+{
+  traffic_simulator::entity::EntityStore store;
+  EXPECT_EQ(store.add("ego", nullptr), static_cast<std::size_t>(0));
+  EXPECT_EQ(store.add("npc", nullptr), static_cast<std::size_t>(1));
+  EXPECT_EQ(store.size(), static_cast<std::size_t>(2));
+  EXPECT_EQ(store.handle("npc"), static_cast<std::size_t>(1));
+  EXPECT_FALSE(store.find("bob"));
+  EXPECT_THROW(store.handle("bob"), common::SemanticError);
+  EXPECT_THROW(store.add("ego", nullptr), common::SemanticError);
+}
+
+TEST(ENTITY_STORE, BOUNDING_BOX)
+{
+  traffic_simulator::entity::EntityStore store;
+  traffic_simulator_msgs::msg::BoundingBox bounding_box;
+  bounding_box.dimensions.x = 4;
+  const auto handle = store.add("npc", nullptr, bounding_box);
+  EXPECT_FALSE(store.status_set()[handle]);
+  EXPECT_DOUBLE_EQ(store.bounding_boxes()[handle].dimensions.x, 4);
+}
+
+TEST(ENTITY_STORE, UPDATE)
+{
+  traffic_simulator::entity::EntityStore store;
+  const auto handle = store.add("ego", nullptr);
+  EXPECT_FALSE(store.status_set()[handle]);
+  traffic_simulator_msgs::msg::EntityStatus status;
+  status.pose = traffic_simulator::helper::constructPose(1, 2, 3, 0, 0, 0);
+  status.action_status.twist.linear.x = 4;
+  status.lanelet_pose = traffic_simulator::helper::constructLaneletPose(34741, 5, 0);
+  status.lanelet_pose_valid = true;
+  store.update(handle, status);
+  EXPECT_TRUE(store.status_set()[handle]);
+  EXPECT_DOUBLE_EQ(store.poses()[handle].position.y, 2);
+  EXPECT_DOUBLE_EQ(store.twists()[handle].linear.x, 4);
+  EXPECT_EQ(store.lanelet_poses()[handle].lanelet_id, 34741);
+  EXPECT_TRUE(store.lanelet_pose_valid()[handle]);
+}
+
+TEST(ENTITY_STORE, REMOVE)
+{
+  traffic_simulator::entity::EntityStore store;
+  store.add("ego", nullptr);
+  store.add("npc1", nullptr);
+  const auto last = store.add("npc2", nullptr);
+  traffic_simulator_msgs::msg::EntityStatus status;
+  status.pose = traffic_simulator::helper::constructPose(7, 0, 0, 0, 0, 0);
+  store.update(last, status);
+  EXPECT_TRUE(store.remove("ego"));
+  EXPECT_FALSE(store.remove("ego"));
+  EXPECT_EQ(store.size(), static_cast<std::size_t>(2));
+  EXPECT_EQ(store.handle("npc1"), static_cast<std::size_t>(0));
+  EXPECT_EQ(store.handle("npc2"), static_cast<std::size_t>(1));
+  EXPECT_EQ(store.name(1), "npc2");
+  EXPECT_DOUBLE_EQ(store.poses()[1].position.x, 7);
+}
+
+int main(int argc, char ** argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
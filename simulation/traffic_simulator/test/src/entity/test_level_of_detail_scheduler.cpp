@@ -0,0 +1,122 @@
+// Copyright 2015-2020 Tier IV, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <traffic_simulator/entity/level_of_detail_scheduler.hpp>
+#include <vector>
+
+auto makePoint(const double x, const double y) -> geometry_msgs::msg::Point
+{
+  geometry_msgs::msg::Point point;
+  point.x = x;
+  point.y = y;
+  return point;
+}
+
+TEST(LEVEL_OF_DETAIL_SCHEDULER, DISABLED)
+{
+  traffic_simulator::entity::LevelOfDetailScheduler scheduler;
+  scheduler.beginFrame({makePoint(0, 0)});
+  EXPECT_FALSE(scheduler.enabled());
+  EXPECT_TRUE(scheduler.schedule(0, makePoint(1000, 0)));
+  EXPECT_EQ(scheduler.getStatistics().full, static_cast<std::size_t>(1));
+}
+
+TEST(LEVEL_OF_DETAIL_SCHEDULER, CLASSIFY)
+{
+  using traffic_simulator::entity::LevelOfDetail;
+  traffic_simulator::entity::LevelOfDetailScheduler scheduler(50, 200, 4);
+  EXPECT_EQ(scheduler.classify(makePoint(1000, 0)), LevelOfDetail::FULL);
+  scheduler.beginFrame({makePoint(0, 0), makePoint(500, 0)});
+  EXPECT_EQ(scheduler.classify(makePoint(30, 0)), LevelOfDetail::FULL);
+  EXPECT_EQ(scheduler.classify(makePoint(100, 0)), LevelOfDetail::REDUCED);
+  EXPECT_EQ(scheduler.classify(makePoint(300, 0)), LevelOfDetail::REDUCED);
+  EXPECT_EQ(scheduler.classify(makePoint(0, 250)), LevelOfDetail::KINEMATIC);
+}
+
+TEST(LEVEL_OF_DETAIL_SCHEDULER, REDUCED_INTERVAL)
+{
+  traffic_simulator::entity::LevelOfDetailScheduler scheduler(50, 200, 4);
+  std::vector<bool> updates;
+  for (int frame = 0; frame < 8; ++frame) {
+    scheduler.beginFrame({makePoint(0, 0)});
+    updates.push_back(scheduler.schedule(0, makePoint(100, 0)));
+  }
+  EXPECT_EQ(updates, std::vector<bool>({true, false, false, true, false, false, false, true}));
+  EXPECT_EQ(scheduler.getStatistics().reduced, static_cast<std::size_t>(1));
+  EXPECT_EQ(scheduler.getStatistics().behavior_updates, static_cast<std::size_t>(1));
+}
+
+TEST(LEVEL_OF_DETAIL_SCHEDULER, PROMOTION)
+{
+  using traffic_simulator::entity::LevelOfDetail;
+  traffic_simulator::entity::LevelOfDetailScheduler scheduler(50, 200, 4);
+  scheduler.beginFrame({makePoint(0, 0)});
+  EXPECT_TRUE(scheduler.schedule(0, makePoint(300, 0)));
+  scheduler.beginFrame({makePoint(0, 0)});
+  EXPECT_FALSE(scheduler.schedule(0, makePoint(300, 0)));
+  EXPECT_EQ(scheduler.getLevelOfDetail(0), LevelOfDetail::KINEMATIC);
+  scheduler.beginFrame({makePoint(0, 0)});
+  EXPECT_TRUE(scheduler.schedule(0, makePoint(150, 0)));
+  scheduler.beginFrame({makePoint(0, 0)});
+  EXPECT_TRUE(scheduler.schedule(0, makePoint(10, 0)));
+  EXPECT_EQ(scheduler.getLevelOfDetail(0), LevelOfDetail::FULL);
+}
+
+TEST(LEVEL_OF_DETAIL_SCHEDULER, STAGGERED_PHASE)
+{
+  traffic_simulator::entity::LevelOfDetailScheduler scheduler(50, 200, 4);
+  std::vector<bool> updates;
+  for (int frame = 0; frame < 4; ++frame) {
+    scheduler.beginFrame({makePoint(0, 0)});
+    scheduler.schedule(0, makePoint(100, 0));
+    updates.push_back(scheduler.schedule(1, makePoint(100, 0)));
+  }
+  EXPECT_EQ(updates, std::vector<bool>({true, false, true, false}));
+}
+
+TEST(LEVEL_OF_DETAIL_SCHEDULER, REQUEST_BEHAVIOR_UPDATE)
+{
+  traffic_simulator::entity::LevelOfDetailScheduler scheduler(50, 200, 4);
+  std::vector<bool> updates;
+  for (int frame = 0; frame < 4; ++frame) {
+    scheduler.beginFrame({makePoint(0, 0)});
+    if (frame == 2) {
+      scheduler.requestBehaviorUpdate(0);
+    }
+    updates.push_back(scheduler.schedule(0, makePoint(300, 0)));
+  }
+  EXPECT_EQ(updates, std::vector<bool>({true, false, true, false}));
+}
+
+TEST(LEVEL_OF_DETAIL_SCHEDULER, REMOVE)
+{
+  using traffic_simulator::entity::LevelOfDetail;
+  traffic_simulator::entity::LevelOfDetailScheduler scheduler(50, 200, 4);
+  scheduler.beginFrame({makePoint(0, 0)});
+  scheduler.schedule(0, makePoint(10, 0));
+  scheduler.schedule(1, makePoint(100, 0));
+  scheduler.schedule(2, makePoint(300, 0));
+  scheduler.remove(0);
+  EXPECT_EQ(scheduler.getLevelOfDetail(0), LevelOfDetail::REDUCED);
+  EXPECT_EQ(scheduler.getLevelOfDetail(1), LevelOfDetail::KINEMATIC);
+  EXPECT_EQ(scheduler.getLevelOfDetail(2), LevelOfDetail::FULL);
+}
+
+int main(int argc, char ** argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,74 @@
+// Copyright 2015-2020 Tier IV, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <traffic_simulator/helper/histogram.hpp>
+
+TEST(HISTOGRAM, EMPTY)
+{
+  traffic_simulator::helper::Histogram histogram;
+  EXPECT_EQ(histogram.count(), static_cast<std::size_t>(0));
+  EXPECT_DOUBLE_EQ(histogram.mean(), 0);
+  EXPECT_DOUBLE_EQ(histogram.percentile(0.5), 0);
+}
+
+TEST(HISTOGRAM, ADD)
+{
+  traffic_simulator::helper::Histogram histogram;
+  histogram.add(std::chrono::microseconds(3));
+  histogram.add(std::chrono::microseconds(3));
+  histogram.add(std::chrono::milliseconds(10));
+  EXPECT_EQ(histogram.count(), static_cast<std::size_t>(3));
+  EXPECT_DOUBLE_EQ(histogram.max(), 0.01);
+  EXPECT_NEAR(histogram.sum(), 0.010006, 1e-12);
+  EXPECT_DOUBLE_EQ(histogram.percentile(0.5), 4e-6);
+  EXPECT_DOUBLE_EQ(histogram.percentile(1.0), 0.01);
+  EXPECT_EQ(histogram.toJson()["buckets"].size(), static_cast<std::size_t>(2));
+}
+
+TEST(HISTOGRAM, OVERFLOW)
+{
+  traffic_simulator::helper::Histogram histogram;
+  histogram.add(std::chrono::seconds(100));
+  EXPECT_DOUBLE_EQ(histogram.max(), 100);
+  EXPECT_DOUBLE_EQ(histogram.percentile(0.5), 100);
+  EXPECT_DOUBLE_EQ(histogram.percentile(0.99), 100);
+  const auto buckets = histogram.toJson()["buckets"];
+  ASSERT_EQ(buckets.size(), static_cast<std::size_t>(1));
+  EXPECT_TRUE(buckets[0]["upper_bound"].is_null());
+  EXPECT_EQ(buckets[0]["count"], static_cast<std::size_t>(1));
+}
+
+TEST(HISTOGRAM, MERGE)
+{
+  traffic_simulator::helper::Histogram histogram;
+  histogram.add(std::chrono::microseconds(3));
+  traffic_simulator::helper::Histogram other;
+  other.add(std::chrono::milliseconds(10));
+  other.add(std::chrono::milliseconds(10));
+  histogram.merge(other);
+  EXPECT_EQ(histogram.count(), static_cast<std::size_t>(3));
+  EXPECT_DOUBLE_EQ(histogram.max(), 0.01);
+  EXPECT_NEAR(histogram.sum(), 0.020003, 1e-12);
+  EXPECT_DOUBLE_EQ(histogram.percentile(0.5), 0.01);
+  EXPECT_EQ(histogram.toJson()["buckets"].size(), static_cast<std::size_t>(2));
+}
+
+int main(int argc, char ** argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -53,6 +53,28 @@ TEST(CatmullRomSpline, GetCollisionPointIn2D)
   }
 }
 
+TEST(CatmullRomSpline, Get2DBoundingBox)
+{
+  geometry_msgs::msg::Point p0;
+  geometry_msgs::msg::Point p1;
+  p1.x = 1;
+  p1.y = 1;
+  geometry_msgs::msg::Point p2;
+  p2.x = 2;
+  auto points = {p0, p1, p2};
+  auto spline = traffic_simulator::math::CatmullRomSpline(points);
+  const auto bounding_box = spline.get2DBoundingBox();
+  for (double s = 0; s <= spline.getLength(); s = s + 0.1) {
+    const auto point = spline.getPoint(s);
+    EXPECT_LE(bounding_box.first.x, point.x);
+    EXPECT_LE(bounding_box.first.y, point.y);
+    EXPECT_GE(bounding_box.second.x, point.x);
+    EXPECT_GE(bounding_box.second.y, point.y);
+  }
+  EXPECT_DOUBLE_EQ(bounding_box.first.x, 0);
+  EXPECT_DOUBLE_EQ(bounding_box.second.x, 2);
+}
+
 TEST(CatmullRomSpline, Maximum2DCurvature)
 {
   geometry_msgs::msg::Point p0;
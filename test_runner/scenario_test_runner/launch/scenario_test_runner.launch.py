@@ -56,51 +56,75 @@ def default_autoware_launch_file_of(architecture_type):
 
 def launch_setup(context, *args, **kwargs):
     # fmt: off
-    architecture_type       = LaunchConfiguration("architecture_type",       default="awf/universe")
-    autoware_launch_file    = LaunchConfiguration("autoware_launch_file",    default=default_autoware_launch_file_of(architecture_type.perform(context)))
-    autoware_launch_package = LaunchConfiguration("autoware_launch_package", default=default_autoware_launch_package_of(architecture_type.perform(context)))
-    global_frame_rate       = LaunchConfiguration("global_frame_rate",       default=30.0)
-    global_real_time_factor = LaunchConfiguration("global_real_time_factor", default=1.0)
-    global_timeout          = LaunchConfiguration("global_timeout",          default=180)
-    initialize_duration     = LaunchConfiguration("initialize_duration",     default=30)
-    launch_autoware         = LaunchConfiguration("launch_autoware",         default=True)
-    launch_rviz             = LaunchConfiguration("launch_rviz",             default=False)
-    output_directory        = LaunchConfiguration("output_directory",        default=Path("/tmp"))
-    port                    = LaunchConfiguration("port",                    default=8080)
-    record                  = LaunchConfiguration("record",                  default=True)
-    scenario                = LaunchConfiguration("scenario",                default=Path("/dev/null"))
-    sensor_model            = LaunchConfiguration("sensor_model",            default="")
-    vehicle_model           = LaunchConfiguration("vehicle_model",           default="")
-    workflow                = LaunchConfiguration("workflow",                default=Path("/dev/null"))
+    architecture_type          = LaunchConfiguration("architecture_type",          default="awf/universe")
+    autoware_launch_file       = LaunchConfiguration("autoware_launch_file",       default=default_autoware_launch_file_of(architecture_type.perform(context)))
+    autoware_launch_package    = LaunchConfiguration("autoware_launch_package",    default=default_autoware_launch_package_of(architecture_type.perform(context)))
+    compact_entity_status      = LaunchConfiguration("compact_entity_status",      default=False)
+    entity_status_publish_rate = LaunchConfiguration("entity_status_publish_rate", default=0.0)
+    global_frame_rate          = LaunchConfiguration("global_frame_rate",          default=30.0)
+    global_real_time_factor    = LaunchConfiguration("global_real_time_factor",    default=1.0)
+    global_timeout             = LaunchConfiguration("global_timeout",             default=180)
+    initialize_duration        = LaunchConfiguration("initialize_duration",        default=30)
+    launch_autoware            = LaunchConfiguration("launch_autoware",            default=True)
+    launch_rviz                = LaunchConfiguration("launch_rviz",                default=False)
+    lidar_map_geometry         = LaunchConfiguration("lidar_map_geometry",         default=False)
+    lod_full_radius            = LaunchConfiguration("lod_full_radius",            default=0.0)
+    lod_reduced_interval       = LaunchConfiguration("lod_reduced_interval",       default=4)
+    lod_reduced_radius         = LaunchConfiguration("lod_reduced_radius",         default=0.0)
+    output_directory           = LaunchConfiguration("output_directory",           default=Path("/tmp"))
+    port                       = LaunchConfiguration("port",                       default=8080)
+    profile_behavior_trees     = LaunchConfiguration("profile_behavior_trees",     default=False)
+    record                     = LaunchConfiguration("record",                     default=True)
+    scenario                   = LaunchConfiguration("scenario",                   default=Path("/dev/null"))
+    sensor_model               = LaunchConfiguration("sensor_model",               default="")
+    update_cost_log_path       = LaunchConfiguration("update_cost_log_path",       default="")
+    vehicle_model              = LaunchConfiguration("vehicle_model",              default="")
+    workflow                   = LaunchConfiguration("workflow",                   default=Path("/dev/null"))
     # fmt: on
 
-    print(f"architecture_type       := {architecture_type.perform(context)}")
-    print(f"autoware_launch_file    := {autoware_launch_file.perform(context)}")
-    print(f"autoware_launch_package := {autoware_launch_package.perform(context)}")
-    print(f"global_frame_rate       := {global_frame_rate.perform(context)}")
-    print(f"global_real_time_factor := {global_real_time_factor.perform(context)}")
-    print(f"global_timeout          := {global_timeout.perform(context)}")
-    print(f"initialize_duration     := {initialize_duration.perform(context)}")
-    print(f"launch_autoware         := {launch_autoware.perform(context)}")
-    print(f"launch_rviz             := {launch_rviz.perform(context)}")
-    print(f"output_directory        := {output_directory.perform(context)}")
-    print(f"port                    := {port.perform(context)}")
-    print(f"record                  := {record.perform(context)}")
-    print(f"scenario                := {scenario.perform(context)}")
-    print(f"sensor_model            := {sensor_model.perform(context)}")
-    print(f"vehicle_model           := {vehicle_model.perform(context)}")
-    print(f"workflow                := {workflow.perform(context)}")
+    print(f"architecture_type          := {architecture_type.perform(context)}")
+    print(f"autoware_launch_file       := {autoware_launch_file.perform(context)}")
+    print(f"autoware_launch_package    := {autoware_launch_package.perform(context)}")
+    print(f"compact_entity_status      := {compact_entity_status.perform(context)}")
+    print(f"entity_status_publish_rate := {entity_status_publish_rate.perform(context)}")
+    print(f"global_frame_rate          := {global_frame_rate.perform(context)}")
+    print(f"global_real_time_factor    := {global_real_time_factor.perform(context)}")
+    print(f"global_timeout             := {global_timeout.perform(context)}")
+    print(f"initialize_duration        := {initialize_duration.perform(context)}")
+    print(f"launch_autoware            := {launch_autoware.perform(context)}")
+    print(f"launch_rviz                := {launch_rviz.perform(context)}")
+    print(f"lidar_map_geometry         := {lidar_map_geometry.perform(context)}")
+    print(f"lod_full_radius            := {lod_full_radius.perform(context)}")
+    print(f"lod_reduced_interval       := {lod_reduced_interval.perform(context)}")
+    print(f"lod_reduced_radius         := {lod_reduced_radius.perform(context)}")
+    print(f"output_directory           := {output_directory.perform(context)}")
+    print(f"port                       := {port.perform(context)}")
+    print(f"profile_behavior_trees     := {profile_behavior_trees.perform(context)}")
+    print(f"record                     := {record.perform(context)}")
+    print(f"scenario                   := {scenario.perform(context)}")
+    print(f"sensor_model               := {sensor_model.perform(context)}")
+    print(f"update_cost_log_path       := {update_cost_log_path.perform(context)}")
+    print(f"vehicle_model              := {vehicle_model.perform(context)}")
+    print(f"workflow                   := {workflow.perform(context)}")
 
     def make_parameters():
         parameters = [
             {"architecture_type": architecture_type},
             {"autoware_launch_file": autoware_launch_file},
             {"autoware_launch_package": autoware_launch_package},
+            {"compact_entity_status": compact_entity_status},
+            {"entity_status_publish_rate": entity_status_publish_rate},
             {"initialize_duration": initialize_duration},
             {"launch_autoware": launch_autoware},
+            {"lidar_map_geometry": lidar_map_geometry},
+            {"lod_full_radius": lod_full_radius},
+            {"lod_reduced_interval": lod_reduced_interval},
+            {"lod_reduced_radius": lod_reduced_radius},
             {"port": port},
+            {"profile_behavior_trees": profile_behavior_trees},
             {"record": record},
             {"sensor_model": sensor_model},
+            {"update_cost_log_path": update_cost_log_path},
             {"vehicle_model": vehicle_model},
         ]
 
@@ -117,19 +141,27 @@ def launch_setup(context, *args, **kwargs):
 
     return [
         # fmt: off
-        DeclareLaunchArgument("architecture_type",       default_value=architecture_type      ),
-        DeclareLaunchArgument("autoware_launch_file",    default_value=autoware_launch_file   ),
-        DeclareLaunchArgument("autoware_launch_package", default_value=autoware_launch_package),
-        DeclareLaunchArgument("global_frame_rate",       default_value=global_frame_rate      ),
-        DeclareLaunchArgument("global_real_time_factor", default_value=global_real_time_factor),
-        DeclareLaunchArgument("global_timeout",          default_value=global_timeout         ),
-        DeclareLaunchArgument("launch_autoware",         default_value=launch_autoware        ),
-        DeclareLaunchArgument("launch_rviz",             default_value=launch_rviz            ),
-        DeclareLaunchArgument("output_directory",        default_value=output_directory       ),
-        DeclareLaunchArgument("scenario",                default_value=scenario               ),
-        DeclareLaunchArgument("sensor_model",            default_value=sensor_model           ),
-        DeclareLaunchArgument("vehicle_model",           default_value=vehicle_model          ),
-        DeclareLaunchArgument("workflow",                default_value=workflow               ),
+        DeclareLaunchArgument("architecture_type",          default_value=architecture_type         ),
+        DeclareLaunchArgument("autoware_launch_file",       default_value=autoware_launch_file      ),
+        DeclareLaunchArgument("autoware_launch_package",    default_value=autoware_launch_package   ),
+        DeclareLaunchArgument("compact_entity_status",      default_value=compact_entity_status     ),
+        DeclareLaunchArgument("entity_status_publish_rate", default_value=entity_status_publish_rate),
+        DeclareLaunchArgument("global_frame_rate",          default_value=global_frame_rate         ),
+        DeclareLaunchArgument("global_real_time_factor",    default_value=global_real_time_factor   ),
+        DeclareLaunchArgument("global_timeout",             default_value=global_timeout            ),
+        DeclareLaunchArgument("launch_autoware",            default_value=launch_autoware           ),
+        DeclareLaunchArgument("launch_rviz",                default_value=launch_rviz               ),
+        DeclareLaunchArgument("lidar_map_geometry",         default_value=lidar_map_geometry        ),
+        DeclareLaunchArgument("lod_full_radius",            default_value=lod_full_radius           ),
+        DeclareLaunchArgument("lod_reduced_interval",       default_value=lod_reduced_interval      ),
+        DeclareLaunchArgument("lod_reduced_radius",         default_value=lod_reduced_radius        ),
+        DeclareLaunchArgument("output_directory",           default_value=output_directory          ),
+        DeclareLaunchArgument("profile_behavior_trees",     default_value=profile_behavior_trees    ),
+        DeclareLaunchArgument("scenario",                   default_value=scenario                  ),
+        DeclareLaunchArgument("sensor_model",               default_value=sensor_model              ),
+        DeclareLaunchArgument("update_cost_log_path",       default_value=update_cost_log_path      ),
+        DeclareLaunchArgument("vehicle_model",              default_value=vehicle_model             ),
+        DeclareLaunchArgument("workflow",                   default_value=workflow                  ),
         # fmt: on
         Node(
             package="scenario_test_runner",